@@ -3,6 +3,7 @@
 
 #define RXD2 16
 #define TXD2 17
+#define IRQ_PIN 4  // the driver's open-drain IRQ line (PB13), active low
 
 typedef CommandParser<> MyCommandParser;
 MyCommandParser parser;
@@ -10,15 +11,36 @@ MyCommandParser parser;
 byte ADDRESS = 0x1;
 #define INFO_BASE 0x0
 #define INFO_VERSION INFO_BASE
+#define INFO_APPLY (INFO_BASE + 0x1)
+#define INFO_REJECTED (INFO_BASE + 0x3)
+#define INFO_HOME (INFO_BASE + 0x4)
 #define CONFIGURATION_BASE 0xA
+#define CONFIGURATION_THREAD_STARTS (CONFIGURATION_BASE + 0x11)
 #define SETTINGS_BASE 0x1E
 #define SETTINGS_MODE SETTINGS_BASE
-#define SETTINGS_GEAR_NUM SETTINGS_MODE | 0x1
-#define SETTINGS_GEAR_DENOM SETTINGS_MODE | 0x2
+#define SETTINGS_PRESET (SETTINGS_BASE + 0x1)
+#define SETTINGS_TARGET (SETTINGS_BASE + 0x3)
+#define SETTINGS_MOVE (SETTINGS_BASE + 0x7)
 #define STATE_BASE 0x32
 #define STATE_RPM STATE_BASE
 #define STATE_POS STATE_BASE | 0x2
-#define VERSION 1
+#define PERF_BASE 0x46
+#define PERF_RECORD_SIZE 0x10
+#define POSITION_BASE 0x8C
+#define POSITION_SPINDLE POSITION_BASE
+#define POSITION_LEADSCREW POSITION_BASE | 0x8
+#define POSITION_INDEX (POSITION_BASE + 0x10)
+#define PITCH_BASE 0xB4
+#define PITCH_NUM PITCH_BASE
+#define PITCH_LEADSCREW (PITCH_BASE + 0x8)
+#define MOTION_BASE 0xC8
+#define MOTION_BACKLASH MOTION_BASE
+#define MOTION_DEADBAND (MOTION_BASE + 0x1)
+#define MOTION_LIMITS (MOTION_BASE + 0x3)
+#define CARRIAGE_BASE 0xDC
+#define CARRIAGE_UM (CARRIAGE_BASE + 0x8)
+#define EVENT_BASE 0xF0
+#define VERSION 7
 
 bool initialized = false;
 
@@ -29,21 +51,45 @@ uint16_t read_word() {
   return w;
 }
 
+uint32_t read_long() {
+  uint32_t l = read_word();
+  uint32_t h = read_word();
+  return (h << 16) | l;
+}
+
+void write_long(uint32_t value) {
+  for (byte i = 0; i < 4; i++) {
+    Wire.write((byte)(value >> (8 * i)));
+  }
+}
+
 void read_info() {
   Wire.beginTransmission(ADDRESS);
   Wire.write(SETTINGS_BASE);
   Wire.endTransmission(false);
-  Wire.requestFrom(ADDRESS, 3, true);
-
+  Wire.requestFrom(ADDRESS, 1, true);
   byte mode = Wire.read();
-  byte num = Wire.read();    // read the driving gear
-  byte denom = Wire.read();  // read the driven gear
   Serial.print("Mode: ");
   Serial.println(mode);
-  Serial.print("Gears: ");
+  Wire.endTransmission();
+
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(PITCH_BASE);
+  Wire.endTransmission(false);
+  Wire.requestFrom(ADDRESS, 16, true);
+  uint32_t num = read_long();
+  uint32_t denom = read_long();
+  uint32_t leadscrew_num = read_long();
+  uint32_t leadscrew_denom = read_long();
+  Serial.print("Pitch: ");
   Serial.print(num, DEC);
   Serial.print("/");
-  Serial.println(denom, DEC);
+  Serial.print(denom, DEC);
+  Serial.print(" on a ");
+  Serial.print(leadscrew_num, DEC);
+  Serial.print("/");
+  Serial.print(leadscrew_denom, DEC);
+  Serial.println(" leadscrew");
   Wire.endTransmission();
 
   Wire.beginTransmission(ADDRESS);
@@ -59,11 +105,58 @@ void read_info() {
   Wire.endTransmission();
 }
 
-void set_gear(byte num, byte denom) {
+// select a preset pitch, 0 uses the pitch set by set_gear()
+void set_preset(byte preset) {
   Wire.beginTransmission(ADDRESS);
-  Wire.write(SETTINGS_GEAR_NUM);
-  Wire.write(num);
-  Wire.write(denom);
+  Wire.write(SETTINGS_PRESET);
+  Wire.write(preset);
+  Wire.endTransmission();
+}
+
+// the pitch cut per spindle revolution, e.g. 5/4 for 1.25 mm or 127/40 for 8 TPI
+void set_gear(uint32_t num, uint32_t denom) {
+  set_preset(0);
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(PITCH_NUM);
+  write_long(num);
+  write_long(denom);
+  Wire.endTransmission();
+}
+
+// the leadscrew pitch in the same unit as the pitch
+void set_leadscrew(uint32_t num, uint32_t denom) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(PITCH_LEADSCREW);
+  write_long(num);
+  write_long(denom);
+  Wire.endTransmission();
+}
+
+// leadscrew backlash in steps and the spindle reversal deadband in encoder counts
+void set_backlash(byte steps, uint16_t counts) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(MOTION_BACKLASH);
+  Wire.write(steps);
+  Wire.write((byte)counts);
+  Wire.write((byte)(counts >> 8));
+  Wire.endTransmission();
+}
+
+// soft limits of the leadscrew position in steps, both enabled
+void set_limits(int32_t left, int32_t right) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(MOTION_LIMITS);
+  Wire.write(0x3);
+  write_long(left);
+  write_long(right);
+  Wire.endTransmission();
+}
+
+// 1 homes at once, 2 when the home switch closes, takes effect without apply
+void home(byte how) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(INFO_HOME);
+  Wire.write(how);
   Wire.endTransmission();
 }
 
@@ -74,6 +167,46 @@ void set_mode(byte mode) {
   Wire.endTransmission();
 }
 
+// apply the CONFIGURATION, SETTINGS and PITCH written so far, returns the offset of
+// an invalid field or 0
+byte apply() {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(INFO_APPLY);
+  Wire.write(1);
+  Wire.endTransmission();
+  delay(1);  // applied by the main loop of the driver
+
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(INFO_REJECTED);
+  Wire.endTransmission(false);
+  Wire.requestFrom(ADDRESS, 1, true);
+  byte rejected = Wire.read();
+  Wire.endTransmission();
+  if (rejected != 0) {
+    Serial.print("Rejected register ");
+    Serial.println(rejected, DEC);
+  }
+  return rejected;
+}
+
+// move to a position in mode 2, target and move in one write
+void move_to(int32_t target, bool rapid) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(SETTINGS_TARGET);
+  write_long(target);
+  Wire.write(rapid ? 2 : 1);
+  Wire.endTransmission();
+}
+
+// engage synchronized motion on the given start of a multi-start thread, 0 starts to engage at once
+void set_thread(byte starts, byte start) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(CONFIGURATION_THREAD_STARTS);
+  Wire.write(starts);
+  Wire.write(start);
+  Wire.endTransmission();
+}
+
 // read from the registry
 void cmd_reg(MyCommandParser::Argument *args, char *response) {
   char offset = args[0].asUInt64;
@@ -93,28 +226,141 @@ void cmd_reg(MyCommandParser::Argument *args, char *response) {
   Wire.endTransmission();
 }
 
+// read the handler timing
+void cmd_perf(MyCommandParser::Argument *args, char *response) {
+  const char *names[] = { "TIM1_CC", "TIM3", "I2C2_EV", "SysTick" };
+  for (byte i = 0; i < 4; i++) {
+    Wire.beginTransmission(ADDRESS);
+    Wire.write(PERF_BASE + i * PERF_RECORD_SIZE);
+    Wire.endTransmission(false);
+    Wire.requestFrom(ADDRESS, PERF_RECORD_SIZE, true);
+    Serial.print(names[i]);
+    Serial.print(": min ");
+    Serial.print(read_word(), DEC);
+    Serial.print(", max ");
+    Serial.print(read_word(), DEC);
+    Serial.print(", mean ");
+    Serial.print(read_word(), DEC);
+    Serial.print(", preempted ");
+    Serial.print(read_word(), DEC);
+    Serial.print(", histogram");
+    for (byte b = 0; b < 4; b++) {
+      Serial.print(" ");
+      Serial.print(read_word(), DEC);
+    }
+    Serial.println();
+    Wire.endTransmission();
+  }
+}
+
+// read the extended positions
+void cmd_pos(MyCommandParser::Argument *args, char *response) {
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(POSITION_BASE);
+  Wire.endTransmission(false);
+  Wire.requestFrom(ADDRESS, 16, true);
+  int64_t spindle = 0, leadscrew = 0;
+  for (byte i = 0; i < 8; i++) {
+    spindle |= (int64_t)Wire.read() << (8 * i);
+  }
+  for (byte i = 0; i < 8; i++) {
+    leadscrew |= (int64_t)Wire.read() << (8 * i);
+  }
+  Wire.endTransmission();
+  Serial.print("Spindle: ");
+  Serial.println((long)spindle, DEC);
+  Serial.print("Leadscrew: ");
+  Serial.println((long)leadscrew, DEC);
+
+  // the carriage from home in micrometres and the spindle angle latched there
+  Wire.beginTransmission(ADDRESS);
+  Wire.write(CARRIAGE_UM);
+  Wire.endTransmission(false);
+  Wire.requestFrom(ADDRESS, 6, true);
+  int32_t um = read_long();
+  uint16_t angle = read_word();
+  Wire.endTransmission();
+  Serial.print("From home: ");
+  Serial.print(um / 1000.0, 3);
+  Serial.print(" mm, homed at spindle angle ");
+  Serial.println(angle, DEC);
+}
+
+// home now (1) or on the home switch (2)
+void cmd_home(MyCommandParser::Argument *args, char *response) {
+  home(args[0].asUInt64);
+}
+
 // set mode
 void cmd_mode(MyCommandParser::Argument *args, char *response) {
   set_mode(args[0].asUInt64);
+  apply();
   read_info();
 }
 
 // set the gearing
 void cmd_gear(MyCommandParser::Argument *args, char *response) {
   set_gear(args[0].asUInt64, args[1].asUInt64);
+  apply();
+  read_info();
+}
+
+// select a preset pitch
+void cmd_preset(MyCommandParser::Argument *args, char *response) {
+  set_preset(args[0].asUInt64);
+  apply();
   read_info();
 }
 
+// set the leadscrew pitch
+void cmd_leadscrew(MyCommandParser::Argument *args, char *response) {
+  set_leadscrew(args[0].asUInt64, args[1].asUInt64);
+  apply();
+  read_info();
+}
+
+// set the backlash and reversal deadband
+void cmd_backlash(MyCommandParser::Argument *args, char *response) {
+  set_backlash(args[0].asUInt64, args[1].asUInt64);
+  apply();
+}
+
+// set the soft limits
+void cmd_limits(MyCommandParser::Argument *args, char *response) {
+  set_limits(args[0].asInt64, args[1].asInt64);
+  apply();
+}
+
 // read information
+void cmd_move(MyCommandParser::Argument *args, char *response) {
+  move_to(args[0].asInt64, args[1].asInt64);
+  apply();
+}
+
+// set the thread start to engage on
+void cmd_thread(MyCommandParser::Argument *args, char *response) {
+  set_thread(args[0].asUInt64, args[1].asUInt64);
+  apply();
+}
+
 void cmd_read(MyCommandParser::Argument *args, char *response) {
   read_info();
 }
 
 void setup_commands() {
   parser.registerCommand("gear", "ii", &cmd_gear);
+  parser.registerCommand("preset", "i", &cmd_preset);
+  parser.registerCommand("leadscrew", "ii", &cmd_leadscrew);
   parser.registerCommand("reg", "ii", &cmd_reg);
   parser.registerCommand("read", "", &cmd_read);
   parser.registerCommand("mode", "i", &cmd_mode);
+  parser.registerCommand("perf", "", &cmd_perf);
+  parser.registerCommand("pos", "", &cmd_pos);
+  parser.registerCommand("move", "ii", &cmd_move);
+  parser.registerCommand("thread", "ii", &cmd_thread);
+  parser.registerCommand("backlash", "ii", &cmd_backlash);
+  parser.registerCommand("limits", "ii", &cmd_limits);
+  parser.registerCommand("home", "i", &cmd_home);
 }
 
 void read_command() {
@@ -129,11 +375,68 @@ void read_command() {
   }
 }
 
+// relay the log frames of the driver, see firmware/devices/log_format.hpp
+// and firmware/tools/log_decoder.hpp for the events
+byte frame[36];
+byte frame_length = 0;
+
 void relay_debug() {
-  if (Serial2.available()) {
-    String stm = Serial2.readString();
-    Serial.print("STM: ");
-    Serial.println(stm);
+  while (Serial2.available()) {
+    byte b = Serial2.read();
+    if (frame_length == 0 && b != 0xA5) {
+      continue;
+    }
+    frame[frame_length++] = b;
+    if (frame_length == 3 && frame[2] > 32) {
+      frame_length = 0;
+      continue;
+    }
+    if (frame_length < 4 || frame_length < frame[2] + 4) {
+      continue;
+    }
+    frame_length = 0;
+    byte sum = 0;
+    for (byte i = 1; i < frame[2] + 3; i++) {
+      sum += frame[i];
+    }
+    if (sum != frame[frame[2] + 3]) {
+      continue;
+    }
+    Serial.print("STM: event ");
+    Serial.print(frame[1], DEC);
+    for (byte i = 0; i < frame[2]; i++) {
+      Serial.print(" ");
+      Serial.print(frame[3 + i], HEX);
+    }
+    Serial.println();
+  }
+}
+
+// pop the queued events while the driver holds the IRQ line low
+void read_events() {
+  while (digitalRead(IRQ_PIN) == LOW) {
+    Wire.beginTransmission(ADDRESS);
+    Wire.write(EVENT_BASE);
+    Wire.endTransmission(false);
+    Wire.requestFrom(ADDRESS, 8, true);
+    byte type = Wire.read();
+    byte pending = Wire.read();
+    uint16_t data = read_word();
+    uint32_t time_ms = read_long();
+    Wire.endTransmission();
+    if (type == 0) {
+      return;
+    }
+    Serial.print("Event ");
+    Serial.print(type, DEC);
+    Serial.print(" data ");
+    Serial.print(data, DEC);
+    Serial.print(" at ");
+    Serial.print(time_ms, DEC);
+    Serial.println(" ms");
+    if (pending == 0) {
+      return;
+    }
   }
 }
 
@@ -145,6 +448,7 @@ void setup() {
 
   Wire.setClock(400000);
   Wire.begin();
+  pinMode(IRQ_PIN, INPUT_PULLUP);
 
   // Start by reading the version
   Serial.println("Reading version:");
@@ -163,6 +467,7 @@ void setup() {
 
   // Initialize driver
   set_gear(1, 10);
+  apply();
   initialized = true;
 
   setup_commands();
@@ -173,5 +478,6 @@ void loop() {
     return;
   }
   read_command();
+  read_events();
   relay_debug();
 }
@@ -1,19 +1,76 @@
 #pragma once
 
 #include <stdint.h>
+#include <numeric>
 #include "../constants.hpp"
 #include "../devices/i2c.hpp"
 
 namespace gear {
-  using Rational = boost::rational<unsigned>;
 
-  struct State {
+  struct Ratio {
     int D, N; // pulse ratio : N/D
-    int err = 0;
-    int output_position = 0;
+
+    // Derived up front so the step ISR can advance without dividing
+    bool incremental; // only exact for N <= D
+    int Q, R; // D = Q * N + R
+    int lo, hi; // error window after a jump: forward [lo, lo + N), reverse [hi - N, hi)
+    uint32_t inv_N; // (2^32 - 1) / N
+    uint8_t burst; // step pulses per jump
+  };
+
+  // n steps per d encoder counts. Above one step per count every jump issues
+  // a burst of pulses instead, and the jumps follow n / (d * burst).
+  constexpr Ratio make_ratio(int d, int n) {
+    int b = n > d ? (n + d - 1) / d : 1;
+    d *= b;
+    int g = std::gcd(d, n);
+    d /= g;
+    n /= g;
+    return { d, n, n <= d, d / n, d % n, -(d / 2), (d + 1) / 2, 0xFFFFFFFFu / n, static_cast<uint8_t>(b) };
+  }
+
+  // The ratio is double buffered: the main loop fills the inactive slot and
+  // raises pending, the step ISR switches slots at its next jump. The ISR
+  // can preempt the main loop but not the other way around, so clearing
+  // pending before touching the inactive slot is enough to keep it whole.
+  struct State {
+    Ratio ratio[2];
+    uint8_t active = 0;
+    bool pending = false;
+    int err = 0; // scaled by D of the active ratio
   };
 
-  volatile State state = { 4, 1 };
+  // Host tools that run a gear per thread make the state thread local
+#ifndef MELS_GEAR_STORAGE
+#define MELS_GEAR_STORAGE
+#endif
+
+  MELS_GEAR_STORAGE volatile State state = { { make_ratio(4, 1), make_ratio(4, 1) } };
+
+  inline volatile Ratio& ratio() {
+    return state.ratio[state.active];
+  }
+
+  // Switch to the pending ratio, keeping the fractional step phase: err is in
+  // units of burst/D steps so it is rescaled to the new D and burst. A finer
+  // burst or a steeper ratio can make that more than a jump of the new ratio,
+  // which the next jump could not take, so only the phase within one is kept.
+  inline void adopt_pending() {
+    if (!state.pending)
+      return;
+    uint8_t next = !state.active;
+    volatile Ratio& r = state.ratio[next];
+    int64_t e = static_cast<int64_t>(state.err) * r.D * ratio().burst;
+    int err = e / (static_cast<int64_t>(ratio().D) * r.burst);
+    err %= r.D;
+    if (err < r.lo)
+      err += r.D;
+    else if (err >= r.hi)
+      err -= r.D;
+    state.err = err;
+    state.active = next;
+    state.pending = false;
+  }
 
   struct Jump {
     uint16_t count;
@@ -26,63 +83,156 @@ namespace gear {
   // Narrowing comes due to integer promotion in arithmetic operations
   // k, the encoder count delta for the next step pulse, should fit within a short integer
 
-  inline Jump next_jump_forward(int d, int n, int e, uint16_t count) {
+  constexpr Jump next_jump_forward(int d, int n, int e, uint16_t count) {
     uint16_t k = (d - 2 * e + 2 * n - 1) / (2 * n);
     return { count + k, k, e + k * n - d };
   }
 
-  inline Jump next_jump_reverse(int d, int n, int e, uint16_t count) {
+  constexpr Jump next_jump_reverse(int d, int n, int e, uint16_t count) {
     uint16_t k = 1 + ((d + 2 * e) / (2 * n));
     return { count - k, k, e - k * n + d };
   }
 
+  // Incremental forms of the above: with the error inside the window left by the
+  // previous jump, k is either Q or Q + 1 and a compare picks which
+  inline Jump step_forward(int q, int r, int n, int lo, int e, uint16_t count) {
+    int k = q;
+    e -= r;
+    if (e < lo) {
+      ++k;
+      e += n;
+    }
+    return { count + k, k, e };
+  }
+
+  inline Jump step_reverse(int q, int r, int n, int hi, int e, uint16_t count) {
+    int k = q;
+    e += r;
+    if (e >= hi) {
+      ++k;
+      e -= n;
+    }
+    return { count - k, k, e };
+  }
+
+  // The next jump in direction dir and the one back, from the error e at the
+  // jump just taken at count
+  template <typename R>
+  inline void next_jumps(R& r, int e, bool dir, uint16_t count, Jump& next, Jump& prev) {
+    int d = r.D, n = r.N;
+    bool incremental = r.incremental;
+    if (!dir) {
+      int lo = r.lo;
+      if (incremental && e >= lo && e < lo + n)
+        next = step_forward(r.Q, r.R, n, lo, e, count);
+      else // first jump after configure or a direction change
+        next = next_jump_forward(d, n, e, count);
+      prev = { static_cast<uint16_t>(count - 1), 1u, e + d - n };
+    } else {
+      int hi = r.hi;
+      if (incremental && e >= hi - n && e < hi)
+        next = step_reverse(r.Q, r.R, n, hi, e, count);
+      else
+        next = next_jump_reverse(d, n, e, count);
+      prev = { static_cast<uint16_t>(count + 1), 1u, e - d + n };
+    }
+  }
+
+  // Encoder counts the spindle must turn back past a jump before the
+  // leadscrew reverses, set from the main loop and taken over by the next
+  // restart or install
+  volatile uint16_t deadband = 0;
+
   struct Range {
     Jump next{}, prev{};
+    uint16_t deadband = 0; // in effect
 
+    // The jumps are worked out as if the encoder read deadband counts more
+    // while the leadscrew turns in reverse, so a reversal either way has to
+    // travel the deadband first and forward threads keep their phase
+    uint16_t shift(bool dir) const {
+      return dir ? deadband : 0;
+    }
+
+    // Called with state.err set to the error at the jump just taken
     void next_jump(bool dir, uint16_t count) {
-      int d = state.D, n = state.N, e = state.err;
-      if (!dir) {
-        next = next_jump_forward(d, n, e, count);
-        prev = { count - 1, 1u, next.error + d - n };
-      } else {
-        next = next_jump_reverse(d, n, e, count);
-        prev = { count + 1, 1u, next.error - d + n };
-      }
+      adopt_pending();
+      next_jumps(ratio(), state.err, dir, count + shift(dir), next, prev);
+      next.count -= shift(dir);
+      prev.count -= shift(!dir);
     }
   };
 #pragma GCC diagnostic pop
 
-  Range range;
+  MELS_GEAR_STORAGE Range range;
 
-  Rational calculate_ratio_for_pitch(const uint8_t& num, const uint8_t& denom) {
+  // Install a new ratio, with forward and reverse its first jumps either way
+  // from zero error as if from count 0. While synchronized the step ISR takes
+  // it over at its next jump and the thread stays in phase; otherwise it is
+  // installed here and the jumps restart from start_position, with the
+  // leadscrew taken to turn forward.
+  void configure(const Ratio& r, Jump forward, Jump reverse, uint16_t start_position) {
     using namespace devices;
-    Rational encoder = {
-      i2c::reg_configuration.encoder_resolution,
-      1
-    };
-    Rational steps_per_rev = {
-      i2c::reg_configuration.stepper_resolution,
-      1
-    };
-
-    Rational pitch{ num, denom };
-
-    return (pitch / constants::leadscrew_pitch) * steps_per_rev / encoder;
+    static bool installed = false;
+    state.pending = false;
+    const uint8_t next = !state.active;
+    state.ratio[next].D = r.D;
+    state.ratio[next].N = r.N;
+    state.ratio[next].incremental = r.incremental;
+    state.ratio[next].Q = r.Q;
+    state.ratio[next].R = r.R;
+    state.ratio[next].lo = r.lo;
+    state.ratio[next].hi = r.hi;
+    state.ratio[next].inv_N = r.inv_N;
+    state.ratio[next].burst = r.burst;
+
+    if (installed && i2c::reg_settings.mode == 0x1) {
+      state.pending = true;
+      return;
+    }
+
+    NVIC_DisableIRQ(TIM1_CC_IRQn);
+    state.active = next;
+    state.err = 0;
+    range.deadband = deadband;
+    range.next = { static_cast<uint16_t>(start_position + forward.count), forward.delta, forward.error };
+    range.prev = { static_cast<uint16_t>(start_position + reverse.count - range.deadband), reverse.delta, reverse.error };
+    encoder::update_channels(range.next.count, range.prev.count);
+    NVIC_EnableIRQ(TIM1_CC_IRQn);
+    installed = true;
   }
-  void configure(const uint8_t& num, const uint8_t& denom, uint16_t start_position) {
-    auto ratio = calculate_ratio_for_pitch(num, denom);
 
-    state.D = ratio.denominator();
-    state.N = ratio.numerator();
+  // A ratio of steps per encoder count as reduced by i2c::step_ratio()
+  void configure(uint32_t steps, uint32_t counts, uint16_t start_position) {
+    Ratio r = make_ratio(counts, steps);
+    configure(r, next_jump_forward(r.D, r.N, 0, 0), next_jump_reverse(r.D, r.N, 0, 0), start_position);
+  }
+
+  // Restart the jumps from the current count with zero error, making it the
+  // phase reference. Only while the compare interrupt does not use the gear.
+  void restart(bool dir, uint16_t count) {
+    using namespace devices;
+    NVIC_DisableIRQ(TIM1_CC_IRQn);
     state.err = 0;
-    range.next = next_jump_forward(ratio.denominator(), ratio.numerator(), 0, start_position);
-    range.prev = next_jump_reverse(ratio.denominator(), ratio.numerator(), 0, start_position);
+    range.deadband = deadband;
+    range.next_jump(dir, count); // also takes over a pending ratio
+    encoder::update_channels(range.next.count, range.prev.count);
+    NVIC_EnableIRQ(TIM1_CC_IRQn);
+  }
+
+  inline unsigned phase_delay_div(uint16_t input_period, int e) {
+    if (e < 0)
+      e = -e;
+    return (input_period * e) / (ratio().N);
   }
 
+  // Same as phase_delay_div but multiplies by the reciprocal of N, the result
+  // is at most one timer tick longer
   inline unsigned phase_delay(uint16_t input_period, int e) {
     if (e < 0)
       e = -e;
-    return (input_period * e) / (state.N);
+    uint32_t x = input_period * static_cast<uint32_t>(e);
+    return (static_cast<uint64_t>(x) * ratio().inv_N + x) >> 32;
   }
 
 }
\ No newline at end of file
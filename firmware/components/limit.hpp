@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+#include "ramp.hpp"
+
+// Soft limits of the leadscrew position (MOTION).
+//
+// While the leadscrew follows the spindle the main loop keeps the positions
+// at which braking has to start for the current speed. The step interrupt
+// checks every pulse against them and hands the leadscrew over to the ramp,
+// which brakes to a stop on the step that reaches the limit. While catching
+// up the speed is the ramp's own, so the step interrupt adds the stopping
+// distance of its level to the position and brakes the same way.
+namespace limit {
+  constexpr uint8_t Left = 0x1; // lower bound of the position
+  constexpr uint8_t Right = 0x2; // upper bound
+
+  constexpr int32_t None_left = std::numeric_limits<int32_t>::min();
+  constexpr int32_t None_right = std::numeric_limits<int32_t>::max();
+
+  struct State {
+    uint8_t enabled = 0;
+    int32_t left = 0, right = 0;
+    // the step interrupt acts at or past these, 32 bits so a plan is never read torn
+    int32_t brake_left = None_left;
+    int32_t brake_right = None_right;
+    uint8_t level = 1; // ramp level braking starts from
+    uint8_t hit = 0; // the limit that stopped the leadscrew, cleared when it starts again
+  };
+
+  volatile State state;
+
+  // Nothing to check, main loop only
+  void clear() {
+    state.brake_left = None_left;
+    state.brake_right = None_right;
+  }
+
+  void configure(uint8_t enabled, int32_t left, int32_t right) {
+    clear();
+    state.enabled = enabled & (Left | Right);
+    state.left = left;
+    state.right = right;
+  }
+
+  // The limits themselves, for the step interrupt to add the ramp's stopping
+  // distance to
+  void at_limits() {
+    state.brake_left = state.enabled & Left ? state.left : None_left;
+    state.brake_right = state.enabled & Right ? state.right : None_right;
+  }
+
+  // Braking from the given speed down to a stop takes the ramp the stopping
+  // distance of its level, plus a slice of slack for the spindle speeding up
+  // before the next plan. Main loop only.
+  void plan(uint32_t velocity) {
+    uint8_t level = std::max<uint8_t>(ramp::level_for(velocity), 1);
+    int64_t distance = ramp::table.stop[level] + ramp::table.steps_per_level;
+    state.level = level;
+    state.brake_left = state.enabled & Left
+      ? static_cast<int32_t>(std::min<int64_t>(state.left + distance, None_right)) : None_left;
+    state.brake_right = state.enabled & Right
+      ? static_cast<int32_t>(std::max<int64_t>(state.right - distance, None_left)) : None_right;
+  }
+
+  // Target of a move kept within the limits, sets hit when it is cut short
+  int32_t clamp(int32_t target) {
+    if ((state.enabled & Left) && target < state.left) {
+      state.hit = Left;
+      return state.left;
+    }
+    if ((state.enabled & Right) && target > state.right) {
+      state.hit = Right;
+      return state.right;
+    }
+    return target;
+  }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include "ramp.hpp"
+#include "../devices/step_gen.hpp"
+
+// Moves to a position that don't follow the spindle (mode 2).
+//
+// The profile is a trapezoid, or a triangle for moves too short to reach the
+// velocity, built from the ramp table: the speed goes up or down one
+// level every steps_per_level steps, and goes up only while the steps left
+// still allow braking back down to the first level one level at a time. The
+// periods are written into the step_gen train buffer a half at a time from
+// the DMA interrupt, so there is no interrupt per step.
+namespace move {
+
+  struct State {
+    uint32_t remaining = 0; // steps not yet written to the train
+    uint8_t level = 0;
+    uint16_t slice = 0; // steps taken at the current level
+    uint8_t filled[2] = {}; // steps in each half of the train
+    bool running = false;
+  };
+
+  volatile State state;
+
+  // Period of the next step, from the DMA interrupt
+  inline uint16_t next_period() {
+    using ramp::table;
+    uint32_t left = state.remaining = state.remaining - 1;
+    if ((state.slice = state.slice + 1) == table.steps_per_level) {
+      state.slice = 0;
+      uint8_t level = state.level;
+      // a slice at level l needs at least l slices to come back down
+      if (level < table.top && left >= (level + 1u) * table.steps_per_level) {
+        state.level = level + 1;
+      } else if (level > 1 && left < static_cast<uint32_t>(level) * table.steps_per_level) {
+        state.level = level - 1;
+      }
+    }
+    return table.period[state.level];
+  }
+
+  inline devices::step_gen::train_entry next_entry() {
+    using devices::step_gen;
+    return state.remaining ? step_gen::train_step(next_period()) : step_gen::train_idle();
+  }
+
+  inline void fill(uint8_t half) {
+    using devices::step_gen;
+    auto* entry = &step_gen::train[half * step_gen::Train_length];
+    uint8_t steps = 0;
+    for (uint8_t i = 0; i < step_gen::Train_length; i++) {
+      steps += state.remaining != 0;
+      entry[i] = next_entry();
+    }
+    state.filled[half] = steps;
+  }
+
+  // Main loop only, with the ramp table configured
+  void start(int32_t steps) {
+    using devices::step_gen;
+    bool reverse = steps < 0;
+    state.remaining = reverse ? -steps : steps;
+    state.level = 1;
+    state.slice = 0;
+    step_gen::change_direction(reverse);
+    uint16_t setup = step_gen::state.counts_reverse.cnt_stop; // the direction has just changed
+    auto first = step_gen::train_step(std::max(next_period(), setup));
+    auto second = next_entry();
+    fill(0);
+    fill(1);
+    state.running = true;
+    step_gen::start_train(first, second);
+  }
+
+  // A half of the train has been sent, from the DMA interrupt. Returns false
+  // once the move has ended and the timer has been handed back.
+  inline bool process_interrupt() {
+    using devices::step_gen;
+    uint8_t half = step_gen::train_half_sent();
+    if (half > 1) {
+      return state.running;
+    }
+    // the last step of the previous half has been taken once a half without
+    // steps has been sent
+    if (state.filled[half] == 0) {
+      step_gen::stop_train();
+      state.running = false;
+      return false;
+    }
+    fill(half);
+    return true;
+  }
+
+  // From the current leadscrew position, main loop only
+  void go_to(int64_t target, uint32_t velocity, uint32_t acceleration) {
+    int64_t steps = target - devices::step_gen::get_position();
+    if (steps == 0) {
+      return;
+    }
+    steps = std::clamp<int64_t>(steps, -std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max());
+    ramp::configure(velocity, acceleration);
+    start(steps);
+  }
+
+  // Stops right away, main loop only
+  void abort() {
+    NVIC_DisableIRQ(DMA1_Channel3_IRQn);
+    NVIC_DisableIRQ(TIM1_UP_IRQn);
+    if (state.running) {
+      devices::step_gen::stop_train();
+      state.running = false;
+    }
+    NVIC_EnableIRQ(TIM1_UP_IRQn);
+    NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+  }
+}
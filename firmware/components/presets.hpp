@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include <utility>
+#include "../constants.hpp"
+#include "../devices/i2c.hpp"
+#include "gear.hpp"
+
+namespace presets {
+
+  // A pitch preset ready for gear::configure(): the reduced step ratio, what
+  // the step ISR derives from it and the first jumps from count 0
+  struct Preset {
+    bool valid; // false when the ratio does not fit the step ISR
+    uint32_t steps, counts;
+    gear::Ratio ratio;
+    gear::Jump forward, reverse;
+  };
+
+  constexpr Preset make_preset(constants::pitch_t pitch, uint32_t encoder, uint32_t stepper,
+    uint32_t leadscrew_num, uint32_t leadscrew_denom) {
+    using devices::i2c;
+    uint32_t steps = 0, counts = 1;
+    if (!i2c::step_ratio(pitch.num, pitch.denom, leadscrew_num, leadscrew_denom, stepper, encoder, steps, counts)
+      || !i2c::burst_fits(steps, counts)) {
+      return {};
+    }
+    gear::Ratio r = gear::make_ratio(counts, steps);
+    return { true, steps, counts, r, gear::next_jump_forward(r.D, r.N, 0, 0), gear::next_jump_reverse(r.D, r.N, 0, 0) };
+  }
+
+#if defined(MELS_ENCODER_RESOLUTION) && defined(MELS_LEADSCREW_NUM)
+  template <size_t... I>
+  constexpr std::array<Preset, sizeof...(I)> make_table(std::index_sequence<I...>) {
+    using namespace devices;
+    return { make_preset(constants::pitch_presets[I], resolution::encoder(0), resolution::stepper(0),
+      leadscrew::num(0), leadscrew::denom(0))... };
+  }
+
+  // The whole hardware is baked in, so every preset is reduced by the compiler
+  constexpr auto table = make_table(std::make_index_sequence<constants::pitch_preset_count>{});
+
+  // preset is 1 based as in SETTINGS
+  inline Preset get(uint8_t preset) {
+    return table[preset - 1];
+  }
+#else
+  inline Preset get(uint8_t preset) {
+    using devices::i2c;
+    auto& c = i2c::reg_configuration;
+    auto& p = i2c::reg_pitch;
+    return make_preset(constants::pitch_presets[preset - 1], c.encoder_resolution, c.stepper_resolution,
+      p.leadscrew_num, p.leadscrew_denom);
+  }
+#endif
+
+}
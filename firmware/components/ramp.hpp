@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include "../devices/step_gen.hpp"
+
+// Catching up with the spindle after engaging while it turns.
+//
+// The leadscrew starts from rest while every gear jump adds its steps to the
+// target. TIM3 free-runs through a table of step periods: the speed goes up
+// or down one level every steps_per_level steps, and the levels are spaced so
+// that this is a constant acceleration (v^2 grows linearly with distance).
+// The main loop keeps a table of how many steps the leadscrew gains on the
+// target while braking from each level down to the synchronized speed, so the
+// step interrupt only compares the steps owed against it. Once the issued
+// steps meet the target the gear takes over. There is no FPU, the speeds of
+// the levels are integer square roots worked out once on configure.
+namespace ramp {
+  constexpr uint8_t Levels = 64;
+
+  struct Table {
+    uint16_t period[Levels + 1]; // timer counts per step at each level, level 0 is standstill
+    uint32_t velocity[Levels + 1]; // steps/s at each level
+    uint16_t steps_per_level = 1;
+    uint8_t top = 1; // level at max velocity
+    uint32_t acceleration = 1; // steps/s^2
+    uint32_t sync = 0; // synchronized speed the brake distances are for, steps/s
+    volatile uint32_t brake[Levels + 1]; // steps gained on the target braking to the synchronized speed
+    uint32_t stop[Levels + 1]; // steps braking to a stop takes, for the soft limits
+  };
+
+  Table table;
+
+  struct State {
+    int32_t target = 0; // steps requested by the gear since engaging
+    int32_t issued = 0;
+    uint8_t level = 0;
+    uint16_t slice = 0; // steps taken at the current level
+    bool running = false;
+    bool braking = false; // to a stop, the level only goes down
+  };
+
+  volatile State state;
+
+  // Floor of the square root
+  inline uint32_t isqrt(uint64_t x) {
+    uint64_t root = 0;
+    for (uint64_t bit = 1ull << 62; bit != 0; bit >>= 2) {
+      if (x >= root + bit) {
+        x -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+    }
+    return static_cast<uint32_t>(root);
+  }
+
+  // Main loop only, the periods are plain divisions done once
+  void configure(uint32_t max_velocity, uint32_t max_acceleration) {
+    using devices::step_gen;
+    table.acceleration = std::max<uint32_t>(max_acceleration, 1);
+    uint64_t distance = static_cast<uint64_t>(max_velocity) * max_velocity / (2 * table.acceleration);
+    table.steps_per_level = std::max<uint64_t>(1, (distance + Levels - 1) / Levels);
+    table.top = Levels;
+    table.sync = ~0u;
+    uint16_t shortest = step_gen::state.counts_step + constants::min_timer_capture_count;
+    table.velocity[0] = 0;
+    for (uint8_t level = 1; level <= Levels; level++) {
+      uint32_t v = isqrt(2ull * table.acceleration * table.steps_per_level * level); // at least 1
+      table.velocity[level] = v;
+      table.stop[level] = static_cast<uint32_t>(static_cast<uint64_t>(v) * v / (2ull * table.acceleration)) + 1;
+      uint64_t period = step_gen::TimerFreq / std::min(v, max_velocity); // the top level is max_velocity
+      table.period[level] = period > 0xFFFF ? 0xFFFF : period < shortest ? shortest : static_cast<uint16_t>(period);
+      if (v >= max_velocity) {
+        table.top = level;
+        break;
+      }
+    }
+  }
+
+  // Highest level not faster than the given speed, main loop only
+  uint8_t level_for(uint32_t velocity) {
+    uint64_t level = static_cast<uint64_t>(velocity) * velocity / (2ull * table.acceleration * table.steps_per_level);
+    return level > table.top ? table.top : level;
+  }
+
+  // Braking from v_j to v_sync takes (v_j - v_sync) / a, during which the
+  // leadscrew gains (v_j - v_sync)^2 / 2a steps on the target. Main loop only.
+  void set_sync_velocity(uint32_t sync) {
+    if (sync == table.sync)
+      return;
+    table.sync = sync;
+    for (uint8_t level = 1; level <= table.top; level++) {
+      uint64_t v = table.velocity[level];
+      uint64_t lead = v > sync ? v - sync : 0;
+      table.brake[level] = lead ? static_cast<uint32_t>(lead * lead / (2ull * table.acceleration)) + 1 : 0;
+    }
+  }
+
+  void engage() {
+    state.target = 0;
+    state.issued = 0;
+    state.running = false;
+    state.braking = false;
+  }
+
+  // A gear jump of the given pulses while ramping, from the compare interrupt
+  inline void add_target(uint8_t pulses) {
+    state.target = state.target + pulses;
+    if (!state.running) {
+      state.running = true;
+      state.braking = false;
+      state.level = 1;
+      state.slice = 0;
+      devices::step_gen::start_free_running(table.period[1]);
+    }
+  }
+
+  // Steps it takes to brake to a stop from the current level, with a slice
+  // of slack for the level going up before braking starts. From the step
+  // interrupt while catching up.
+  inline uint32_t reach() {
+    return table.stop[state.level] + table.steps_per_level;
+  }
+
+  // Brake from the given level to a stop on the pulse that makes steps, from
+  // the step interrupt. The slack limit::plan() and reach() leave may make
+  // owed exceed the stopping distance, which must not speed it up again.
+  inline void brake(int32_t steps, uint8_t level) {
+    state.target = steps;
+    state.issued = 0;
+    state.level = level;
+    state.slice = 0;
+    state.running = true;
+    state.braking = true;
+    devices::step_gen::start_free_running(table.period[level]);
+  }
+
+  // A pulse has been issued, from the step interrupt. Returns false once the
+  // leadscrew has caught up and the timer has been handed back.
+  inline bool step() {
+    using devices::step_gen;
+    int32_t owed = state.target - (state.issued = state.issued + 1);
+    if (owed <= 0) {
+      step_gen::stop_free_running();
+      state.running = false;
+      return false;
+    }
+    if ((state.slice = state.slice + 1) == table.steps_per_level) {
+      state.slice = 0;
+      uint32_t distance = state.braking ? table.stop[state.level] : table.brake[state.level];
+      if (static_cast<uint32_t>(owed) > distance) {
+        if (state.level < table.top && !state.braking)
+          state.level = state.level + 1;
+      } else if (state.level > 1) {
+        state.level = state.level - 1;
+      }
+    }
+    step_gen::set_period(table.period[state.level]);
+    return true;
+  }
+
+  void abort() {
+    if (state.running) {
+      devices::step_gen::stop_free_running();
+      state.running = false;
+    }
+  }
+}
@@ -1,18 +1,52 @@
 #pragma once
 
-#include <boost/rational_minimal.hpp>
 #include <chrono>
+#include <numeric>
+#include <stdint.h>
+#include <utility>
 
 namespace constants {
     using namespace std::chrono_literals;
     constexpr auto onesec_in_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(1s);
 
-    using Rational = boost::rational<unsigned>;
     using gearing_ratio_t = std::pair<uint16_t, uint16_t>;
 
     constexpr uint64_t CPU_Clock_Freq_Hz = 72 * std::mega::num;
     constexpr uint16_t min_timer_capture_count = 5;
 
-    // leadscrew
-    Rational leadscrew_pitch{ 2, 1 };
-}
\ No newline at end of file
+    // A thread pitch in mm per spindle revolution, reduced
+    struct pitch_t {
+        uint32_t num, denom;
+    };
+
+    constexpr pitch_t metric_pitch(uint32_t hundredths) {
+        uint32_t g = std::gcd(hundredths, 100u);
+        return { hundredths / g, 100 / g };
+    }
+
+    // 25.4 mm per inch over the threads per inch, given in tenths
+    constexpr pitch_t imperial_pitch(uint32_t tenths_tpi) {
+        uint32_t g = std::gcd(254u, tenths_tpi);
+        return { 254 / g, tenths_tpi / g };
+    }
+
+    // The pitches selectable by SETTINGS preset, from 1: the ISO metric coarse
+    // and fine pitches, then the UNC, UNF and BSW threads per inch
+    constexpr pitch_t pitch_presets[] = {
+        metric_pitch(20), metric_pitch(25), metric_pitch(30), metric_pitch(35),
+        metric_pitch(40), metric_pitch(45), metric_pitch(50), metric_pitch(60),
+        metric_pitch(70), metric_pitch(75), metric_pitch(80), metric_pitch(100),
+        metric_pitch(125), metric_pitch(150), metric_pitch(175), metric_pitch(200),
+        metric_pitch(250), metric_pitch(300), metric_pitch(350), metric_pitch(400),
+        metric_pitch(450), metric_pitch(500), metric_pitch(550), metric_pitch(600),
+        imperial_pitch(40), imperial_pitch(45), imperial_pitch(50), imperial_pitch(60),
+        imperial_pitch(70), imperial_pitch(80), imperial_pitch(90), imperial_pitch(100),
+        imperial_pitch(110), imperial_pitch(115), imperial_pitch(120), imperial_pitch(130),
+        imperial_pitch(140), imperial_pitch(160), imperial_pitch(180), imperial_pitch(190),
+        imperial_pitch(200), imperial_pitch(240), imperial_pitch(270), imperial_pitch(280),
+        imperial_pitch(320), imperial_pitch(360), imperial_pitch(400), imperial_pitch(440),
+        imperial_pitch(480), imperial_pitch(560), imperial_pitch(640), imperial_pitch(720),
+        imperial_pitch(800)
+    };
+    constexpr uint8_t pitch_preset_count = sizeof(pitch_presets) / sizeof(pitch_presets[0]);
+}
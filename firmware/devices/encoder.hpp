@@ -1,5 +1,6 @@
 #pragma once
 #include "stm32f103xb.h"
+#include "../constants.hpp"
 
 namespace devices {
 
@@ -8,6 +9,36 @@ namespace devices {
 
         static constexpr uint16_t Prescaler = 4; // Period of a single channel contains 4 encoder changes
         volatile static inline uint16_t last_full_period = 0;
+        volatile static inline int64_t count_base = 0; // counts carried out of the 16 bit counter
+        volatile static inline uint8_t generation = 0; // bumped whenever count_base moves
+        volatile static inline CounterValue index_capture = 0; // TIM1 count at the last index pulse, written by DMA
+        volatile static inline int64_t index_count = 0; // extended count at the last index pulse
+        volatile static inline bool index_seen = false;
+
+        // Input filter settings from the shortest to the longest sampling
+        // window, as CR1 CKD and CCMR1 ICxF with the window in timer clocks
+        struct filter_setting {
+            uint8_t ckd, icf;
+            uint16_t window;
+        };
+        static constexpr filter_setting Filters[] = {
+            { 0, 0x3, 8 }, // fCK_INT, N = 8
+            { 0, 0x5, 16 }, // fDTS / 2, N = 8
+            { 0, 0x7, 32 }, // fDTS / 4, N = 8
+            { 0, 0x9, 64 }, // fDTS / 8, N = 8
+            { 0, 0xC, 128 }, // fDTS / 16, N = 8
+            { 0, 0xF, 256 }, // fDTS / 32, N = 8
+            { 1, 0xF, 512 }, // tDTS = 2 tCK_INT
+            { 2, 0xF, 1024 }, // tDTS = 4 tCK_INT, 14 us
+        };
+        static constexpr uint8_t Filter_count = sizeof(Filters) / sizeof(Filters[0]);
+        static constexpr uint32_t Timer_clock = constants::CPU_Clock_Freq_Hz;
+        static constexpr uint16_t Glitch_ms = 20; // a reversal undone sooner is counted as a glitch
+
+        volatile static inline uint8_t filter = Filter_count - 1; // current entry of Filters
+        volatile static inline uint32_t glitches = 0;
+        volatile static inline uint32_t last_reversal_ms = 0;
+        volatile static inline uint32_t overruns = 0; // compares served late or passed before they were set
 
         static void init() {
             // encoder pins
@@ -21,14 +52,15 @@ namespace devices {
 
             // set up Timer1 in encoder mode
             TIM1->CCMR1 |= TIM_CCMR1_CC1S_0; // CC1 channel is configured as input, IC1 is mapped on TI1
-            TIM1->CCMR1 |= TIM_CCMR1_IC1F_0 | TIM_CCMR1_IC1F_1; // filter: n = 8
             TIM1->CCMR1 |= TIM_CCMR1_CC2S_0; // CC2 channel is configured asinput, IC2 is mapped on TI2
-            TIM1->CCMR1 |= TIM_CCMR1_IC2F_0 | TIM_CCMR1_IC1F_1; // filter: n = 8
+            set_filter(Filter_count - 1); // stopped, see adapt_filter()
             TIM1->CCMR2 |= TIM_CCMR2_OC3M_0; // Set on match
             TIM1->SMCR |= TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1; // both input active on both rising and falling edges
             TIM1->CR2 |= TIM_CR2_MMS_1 | TIM_CR2_MMS_2; // OC3REF signal is used as trigger output (TRGO)
             TIM1->CCER |= TIM_CCER_CC3E; // Capture/Compare 3 ouput enable
             TIM1->BDTR |= TIM_BDTR_MOE; // OC and OCN outputs are enabled if the respective bits is set in CCER
+            TIM1->DIER |= TIM_DIER_UIE; // Update interrupt enabled, extends the count past 16 bits
+            NVIC_EnableIRQ(TIM1_UP_IRQn);
 
             TIM1->CR1 |= TIM_CR1_CEN; // Counter enabled
 
@@ -50,8 +82,8 @@ namespace devices {
             TIM2->DIER |= TIM_DIER_CC3IE; // CC3 interrupt enabled
 
             // set up DMA to capture the lenght of the last full period
-            DMA1_Channel7->CPAR = reinterpret_cast<unsigned>(std::addressof(TIM2->CCR2)); // Set the peripheral address register to that of TIM2's Capture/Compare register 2
-            DMA1_Channel7->CMAR = reinterpret_cast<unsigned>(std::addressof(last_full_period));
+            DMA1_Channel7->CPAR = reinterpret_cast<uintptr_t>(std::addressof(TIM2->CCR2)); // Set the peripheral address register to that of TIM2's Capture/Compare register 2
+            DMA1_Channel7->CMAR = reinterpret_cast<uintptr_t>(std::addressof(last_full_period));
             DMA1_Channel7->CNDTR = 1; // the number of data to be transferred
             DMA1_Channel7->CCR &= ~(DMA_CCR_MSIZE |
                 DMA_CCR_PSIZE |
@@ -66,9 +98,73 @@ namespace devices {
             TIM2->CCER |= TIM_CCER_CC1E; // enable capture
             TIM2->CR1 |= TIM_CR1_CEN; // enable timer
 
+            // index pulse on PB7 (TIM4 CH2, TIM4 itself counts step pulses), the
+            // capture has DMA copy the encoder count so it is exact at any speed.
+            // PB6 is the UART TX, and IC1 is used for its DMA request on channel 1.
+            GPIOB->CRL &= ~(GPIO_CRL_CNF7_Msk | GPIO_CRL_MODE7_Msk); // clear the default bits
+            GPIOB->CRL |= GPIO_CRL_CNF7_1; // input pull-down/pull-up
+            GPIOB->BSRR |= GPIO_BSRR_BR7; // pull low, active high
+            TIM4->CCMR1 |= TIM_CCMR1_CC1S_1; // CC1 channel is configured as input, IC1 is mapped on TI2
+            TIM4->CCMR1 |= TIM_CCMR1_IC1F_0 | TIM_CCMR1_IC1F_1; // filter: n = 8
+            TIM4->DIER |= TIM_DIER_CC1DE; // CC1 DMA request enabled
+            DMA1_Channel1->CPAR = reinterpret_cast<uintptr_t>(std::addressof(TIM1->CNT));
+            DMA1_Channel1->CMAR = reinterpret_cast<uintptr_t>(std::addressof(index_capture));
+            DMA1_Channel1->CNDTR = 1;
+            DMA1_Channel1->CCR &= ~(DMA_CCR_MSIZE |
+                DMA_CCR_PSIZE |
+                DMA_CCR_EN);
+            DMA1_Channel1->CCR |= (0x1 << DMA_CCR_MSIZE_Pos) // 16 bits
+                | (0x1 << DMA_CCR_PSIZE_Pos) // 16 bits
+                | DMA_CCR_CIRC // circular mode -> continuous
+                | DMA_CCR_TCIE; // interrupt after each capture
+            DMA1_Channel1->CCR |= DMA_CCR_EN;
+            NVIC_SetPriority(DMA1_Channel1_IRQn, 1); // below TIM1_UP, see get_extended_count()
+            NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+            TIM4->CCER |= TIM_CCER_CC1E; // enable capture, rising edge
+
             setup_cc_interrupt();
         }
 
+        // The same filter on both channels, only from the main loop
+        static void set_filter(uint8_t level) {
+            const filter_setting& f = Filters[level];
+            TIM1->CCMR1 = (TIM1->CCMR1 & ~(TIM_CCMR1_IC1F_Msk | TIM_CCMR1_IC2F_Msk))
+                | (f.icf << TIM_CCMR1_IC1F_Pos) | (f.icf << TIM_CCMR1_IC2F_Pos);
+            TIM1->CR1 = (TIM1->CR1 & ~TIM_CR1_CKD_Msk) | (f.ckd << TIM_CR1_CKD_Pos);
+            filter = level;
+        }
+
+        // The longest filter whose window is at most an eighth of a channel
+        // pulse (two counts) at the given speed, room for an uneven duty cycle
+        // and for the spindle to speed up before the next poll
+        static uint8_t filter_for(uint32_t counts_per_second) {
+            uint8_t level = Filter_count - 1;
+            while (level > 0 && uint64_t(Filters[level].window) * 4 * counts_per_second > Timer_clock) {
+                level--;
+            }
+            return level;
+        }
+
+        // Long filters reject chatter while the spindle is slow or stopped, and
+        // shorter ones keep up as it speeds up. Shortened at once, lengthened
+        // only once the spindle is at half the speed the longer one allows.
+        static void adapt_filter(uint32_t counts_per_second) {
+            uint8_t level = filter_for(counts_per_second);
+            if (level < filter) {
+                set_filter(level);
+            } else if (level > filter && (level = filter_for(2 * counts_per_second)) > filter) {
+                set_filter(level);
+            }
+        }
+
+        // From the compare interrupt on each reversal of the spindle
+        static inline void reversed(uint32_t now_ms) {
+            if (now_ms - last_reversal_ms < Glitch_ms) {
+                glitches = glitches + 1;
+            }
+            last_reversal_ms = now_ms;
+        }
+
         static void setup_cc_interrupt() {
             TIM1->DIER |= TIM_DIER_CC3IE; // CC3 interrupt enabled
             TIM1->DIER |= TIM_DIER_CC4IE; // CC4 interrupt enabled
@@ -89,12 +185,34 @@ namespace devices {
             TIM1->CCR4 = prev;
         }
 
+        // From the compare interrupt before the jump: the count is still on the
+        // compare that fired unless the interrupt was late, then the jump is
+        // taken from where the spindle is and the steps in between are lost
+        static inline void check_late(CounterValue count, bool fwd) {
+            if (count != (fwd ? TIM1->CCR3 : TIM1->CCR4)) {
+                overruns = overruns + 1;
+            }
+        }
+
+        // From the compare interrupt once both compares are set. A compare
+        // only matches when the counter moves onto it, so the count has to
+        // lie strictly between them or the step of the one it reached is lost.
+        static inline void check_compares(CounterValue next, CounterValue prev) {
+            CounterValue c = TIM1->CNT;
+            auto to_next = static_cast<int16_t>(next - c);
+            auto to_prev = static_cast<int16_t>(prev - c);
+            if (to_next == 0 || to_prev == 0 || (to_next > 0) == (to_prev > 0)) {
+                overruns = overruns + 1;
+            }
+        }
+
         static void inline trigger_clear() {
             TIM1->CCMR2 &= ~TIM_CCMR2_OC3M_Msk;
             TIM1->CCMR2 |= TIM_CCMR2_OC3M_2; // force oc3ref low
         }
 
         static void inline trigger_restore() {
+            TIM1->CCMR2 &= ~TIM_CCMR2_OC3M_Msk;
             TIM1->CCMR2 |= TIM_CCMR2_OC3M_0; // Set on match
         }
 
@@ -105,18 +223,72 @@ namespace devices {
             trigger_restore();
         }
 
+        // Direction of the last count, true when counting down
+        static inline bool get_direction() {
+            return TIM1->CR1 & TIM_CR1_DIR;
+        }
+
         static inline CounterValue get_count() {
             return TIM1->CNT;
         }
 
+        // The counter wrapped. DIR may have changed since if the spindle
+        // turned back, the half the counter is in tells which way it went.
+        static inline void process_update() {
+            TIM1->SR &= ~TIM_SR_UIF_Msk;
+            count_base = count_base + (TIM1->CNT < 0x8000 ? 0x10000 : -0x10000);
+            generation = generation + 1;
+        }
+
+        static inline uint8_t get_generation() {
+            return generation;
+        }
+
+        // Only valid while the update interrupt can preempt the caller
+        static int64_t get_extended_count() {
+            int64_t base;
+            CounterValue count;
+            uint8_t g;
+            do {
+                g = generation;
+                base = count_base;
+                count = TIM1->CNT;
+            } while (g != generation || (TIM1->SR & TIM_SR_UIF)); // retry if a wrap is pending
+            return base + count;
+        }
+
         static inline void process_interrupt() {
             last_full_period = 0; // time out - too slow
             TIM2->SR &= ~TIM_SR_CC3IF_Msk;
         }
 
+        // The index count has been captured, extend it from the current count
+        static inline void process_index() {
+            DMA1->IFCR |= DMA_IFCR_CTCIF1;
+            int64_t now = get_extended_count();
+            int16_t since = static_cast<CounterValue>(now) - index_capture;
+            index_count = now - since;
+            index_seen = true;
+        }
+
+        // index_count as written by one index interrupt, from any context it
+        // can preempt
+        static inline int64_t get_index_count() {
+            int64_t c;
+            do {
+                c = index_count;
+            } while (c != index_count);
+            return c;
+        }
+
+        // The compare value of the forward channel
+        static inline CounterValue get_next() {
+            return TIM1->CCR3;
+        }
+
         static inline uint16_t last_duration() {
             return last_full_period;
         }
     };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "stm32f103xb.h"
+
+namespace devices {
+
+    // One event as read from EVENT
+#pragma pack(1)
+    typedef struct {
+        uint8_t type; // events::Limit, ..., 0 when none was queued
+        uint8_t pending; // events still queued behind this one
+        uint16_t data;
+        uint32_t time_ms; // since power on
+    } event_record_t;
+#pragma pack(0)
+
+    // Events for the host, queued by the main loop, the only producer, and
+    // popped by reads of EVENT from the I2C interrupt, the only consumer.
+    // The open-drain host interrupt line on PB13 is held low while any are
+    // queued, so the host only reads when there is something to read.
+    struct events {
+        static constexpr uint8_t Overflow = 1; // data: events dropped while the queue was full
+        static constexpr uint8_t Limit = 2; // data: 1 left, 2 right
+        static constexpr uint8_t In_sync = 3; // following the spindle, data: encoder count
+        static constexpr uint8_t Stopped = 4; // data: the control state stopped from
+        static constexpr uint8_t Overrun = 5; // data: compares the spindle passed before they were set
+        static constexpr uint8_t Rejected = 6; // data: offset of the first invalid field
+        static constexpr uint8_t Homed = 7; // data: spindle angle past the index, 0xFFFF before it
+        static constexpr uint8_t Ring_size = 16; // power of two
+
+        static void init() {
+            GPIOB->BSRR |= GPIO_BSRR_BS13; // released
+            GPIOB->CRH &= ~(GPIO_CRH_CNF13_Msk | GPIO_CRH_MODE13_Msk); // reset
+            GPIOB->CRH |= GPIO_CRH_CNF13_0; // General purpose output Open-drain
+            GPIOB->CRH |= GPIO_CRH_MODE13_1; // Output mode, max speed 2MHz
+        }
+
+        // Main loop. When the queue is full the event is dropped and counted
+        // in an overflow event once there is room again.
+        static void push(uint8_t type, uint16_t data, uint32_t time_ms) {
+            if (dropped != 0 && put(Overflow, dropped, time_ms)) {
+                dropped = 0;
+            }
+            if (!put(type, data, time_ms) && dropped != 0xFFFF) {
+                dropped = dropped + 1;
+            }
+            update_line();
+        }
+
+        // I2C interrupt
+        static void pop(volatile event_record_t& r) {
+            uint8_t t = tail;
+            uint8_t h = head;
+            if (t == h) {
+                r.type = 0;
+                r.pending = 0;
+                r.data = 0;
+                r.time_ms = 0;
+                return;
+            }
+            auto& src = ring[t % Ring_size];
+            r.type = src.type;
+            r.pending = h - t - 1;
+            r.data = src.data;
+            r.time_ms = src.time_ms;
+            tail = t + 1;
+            update_line();
+        }
+
+    private:
+        volatile static inline event_record_t ring[Ring_size];
+        volatile static inline uint8_t head = 0; // next event queued, free running
+        volatile static inline uint8_t tail = 0; // next event popped, free running
+        volatile static inline uint16_t dropped = 0; // since the last overflow event
+
+        static bool put(uint8_t type, uint16_t data, uint32_t time_ms) {
+            uint8_t h = head;
+            if (static_cast<uint8_t>(h - tail) == Ring_size) {
+                return false;
+            }
+            auto& r = ring[h % Ring_size];
+            r.type = type;
+            r.data = data;
+            r.time_ms = time_ms;
+            head = h + 1; // publish after the event is complete
+            return true;
+        }
+
+        // Both sides set the line from the queue as it is now, so whichever
+        // runs last leaves it right
+        static void update_line() {
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            if (head != tail) {
+                GPIOB->BSRR |= GPIO_BSRR_BR13; // asserted, active low
+            } else {
+                GPIOB->BSRR |= GPIO_BSRR_BS13;
+            }
+            __set_PRIMASK(primask);
+        }
+    };
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "stm32f103xb.h"
+#include "encoder.hpp"
+#include "step_gen.hpp"
+
+namespace devices {
+
+    // Zero of the absolute position. Homing makes the carriage position 0 and
+    // latches the spindle angle in the same interrupt, either on command or
+    // when the home switch on PB12 closes to ground. A command raises EXTI
+    // line 12 from software, so both take the same path.
+    struct home {
+        static constexpr uint8_t Now = 0x1; // INFO home commands
+        static constexpr uint8_t On_switch = 0x2;
+        static constexpr uint16_t No_angle = 0xFFFF; // homed before the index was seen
+
+        volatile static inline bool homed = false;
+        volatile static inline bool waiting = false; // for the switch to close
+        volatile static inline uint16_t angle = No_angle; // encoder counts past the index when homed
+        volatile static inline uint8_t homings = 0; // bumped on every homing, for the main loop to notice
+
+        static void init() {
+            GPIOB->CRH &= ~(GPIO_CRH_CNF12_Msk | GPIO_CRH_MODE12_Msk); // clear the default bits
+            GPIOB->CRH |= GPIO_CRH_CNF12_1; // input pull-down/pull-up
+            GPIOB->BSRR |= GPIO_BSRR_BS12; // pull high, active low
+            AFIO->EXTICR[3] &= ~AFIO_EXTICR4_EXTI12_Msk;
+            AFIO->EXTICR[3] |= AFIO_EXTICR4_EXTI12_PB;
+            EXTI->IMR |= EXTI_IMR_MR12;
+            NVIC_SetPriority(EXTI15_10_IRQn, 1); // below TIM1_UP, see encoder::get_extended_count()
+            NVIC_EnableIRQ(EXTI15_10_IRQn);
+        }
+
+        // 1 homes at once, 2 on the next closing of the switch, 0 stops waiting
+        static void command(uint8_t c) {
+            waiting = c == On_switch;
+            if (waiting) {
+                EXTI->FTSR |= EXTI_FTSR_TR12;
+            } else {
+                EXTI->FTSR &= ~EXTI_FTSR_TR12;
+            }
+            if (c == Now) {
+                EXTI->SWIER |= EXTI_SWIER_SWIER12;
+            }
+        }
+
+        // bit 0 homed, bit 1 waiting for the switch
+        static uint8_t status() {
+            return (homed ? Now : 0) | (waiting ? On_switch : 0);
+        }
+
+        // From the EXTI interrupt. The switch only homes once, its bounce
+        // is ignored until it is armed again.
+        static void process_interrupt(uint16_t resolution) {
+            EXTI->PR = EXTI_PR_PR12; // also clears a software request
+            EXTI->FTSR &= ~EXTI_FTSR_TR12;
+            waiting = false;
+            int64_t count = encoder::get_extended_count();
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            step_gen::set_home();
+            __set_PRIMASK(primask);
+            if (encoder::index_seen) {
+                angle = ((count - encoder::get_index_count()) % resolution + resolution) % resolution;
+            } else {
+                angle = No_angle;
+            }
+            homed = true;
+            homings = homings + 1;
+        }
+    };
+}
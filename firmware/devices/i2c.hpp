@@ -1,18 +1,35 @@
 #pragma once
+#include <cstddef>
+#include <numeric>
 #include "stm32f103xb.h"
 #include "../constants.hpp"
+#include "resolution.hpp"
 #include "rpm.hpp"
 #include "encoder.hpp"
+#include "events.hpp"
+#include "home.hpp"
+#include "perf.hpp"
+#include "step_gen.hpp"
+#include "telemetry.hpp"
 
 namespace devices {
 
     using gearing_ratio_t = std::pair<uint16_t, uint16_t>;
 
-    constexpr char version{ 1 };
+    constexpr char version{ 7 };
 
 #pragma pack(1)
     typedef struct {
         uint8_t version;
+        // write 1 to apply what has been written to CONFIGURATION and SETTINGS
+        uint8_t apply;
+        // bumped every time they have been applied
+        uint8_t generation;
+        // offset of the first invalid field of the last apply, nothing is applied then, 0 when applied
+        uint8_t rejected;
+        // write 1 to home at once, 2 to home when the switch closes, 0 to stop
+        // waiting, takes effect without apply; reads bit 0 homed, bit 1 waiting
+        uint8_t home;
     } reg_info_t;
 
     // todo: move most constants into this
@@ -32,106 +49,478 @@ namespace devices {
         // [invert_step_pin, invert_dir_pin, ...]
         char stepper_flags;
 
+        // limits used when catching up with the spindle, steps/s and steps/s^2
+        uint32_t max_velocity;
+        uint32_t max_acceleration;
+
+        // 0 engages at once, otherwise engaging waits for the spindle to reach
+        // start thread_start of thread_starts, counted from the index pulse
+        uint8_t thread_starts;
+        uint8_t thread_start;
+
+        // interval in ms between spindle speed updates
+        uint8_t rpm_update_ms;
+
     } reg_configuration_t;
 
 #pragma pack(1)
     typedef struct {
         char mode;
-        uint8_t gear_num;
-        uint8_t gear_denom;
+        // 1 to constants::pitch_preset_count selects a preset pitch, which is
+        // written to PITCH on apply, 0 leaves PITCH as written
+        uint8_t preset;
+        // held the high byte of the 8 bit gear before version 3
+        uint8_t reserved;
+        // position to move to in mode 2
+        int32_t target;
+        // 1 to move to target at feed_velocity, 2 at rapid_velocity, cleared when the move starts
+        uint8_t move;
+        // steps/s and steps/s^2, limited by max_velocity and max_acceleration
+        uint32_t feed_velocity;
+        uint32_t rapid_velocity;
+        uint32_t acceleration;
     } reg_settings_t;
 
 #pragma pack(1)
     typedef struct {
         uint16_t rpm;
         uint16_t pos;
+        uint8_t control; // 0 stopped, 1 in sync, 2 ramping, 3 moving, 4 armed
+        int32_t speed; // 0.1 rpm, negative in reverse
+        int32_t acceleration; // 0.1 rpm/s
+        uint32_t glitches; // spindle reversals undone within encoder::Glitch_ms
+        uint8_t input_filter; // encoder::Filters entry in use, 0 the shortest
+        uint8_t limit; // 1 left, 2 right: the soft limit that stopped the leadscrew
     } reg_state_t;
 
+#pragma pack(1)
+    typedef struct {
+        int64_t spindle_count;
+        int64_t leadscrew_position;
+        int64_t index_count;
+    } reg_position_t;
+
+#pragma pack(1)
+    typedef struct {
+        perf_record_t handlers[perf::handler_count];
+    } reg_perf_t;
+
+#pragma pack(1)
+    typedef struct {
+        // length cut per spindle revolution
+        uint32_t pitch_num;
+        uint32_t pitch_denom;
+        // length travelled per leadscrew revolution, in the same unit as the
+        // pitch, e.g. 2/1 mm or 127/40 mm for 8 TPI
+        uint32_t leadscrew_num;
+        uint32_t leadscrew_denom;
+    } reg_pitch_t;
+
+#pragma pack(1)
+    typedef struct {
+        // 0 off, otherwise every nth step ISR jump is sent, takes effect without apply
+        uint8_t decimation;
+        // records lost because the UART could not keep up
+        uint32_t overflows;
+    } reg_telemetry_t;
+
+#pragma pack(1)
+    typedef struct {
+        // lost motion of the leadscrew nut in steps, taken up with extra steps
+        // when synchronized motion reverses
+        uint8_t backlash;
+        // encoder counts the spindle must turn back before the leadscrew
+        // follows a reversal, takes effect when engaging
+        uint16_t deadband;
+        // soft limits of leadscrew_position, bit 0 enables left_limit, bit 1 right_limit
+        uint8_t limits;
+        int32_t left_limit;
+        int32_t right_limit;
+    } reg_motion_t;
+
+#pragma pack(1)
+    typedef struct {
+        // leadscrew_position with the backlash taken out, 0 at home
+        int64_t position;
+        // position in micrometres, for pitches given in mm
+        int32_t position_um;
+        // encoder counts the spindle was past the index when homed, 0xFFFF
+        // when homed before the index was seen
+        uint16_t home_angle;
+    } reg_carriage_t;
+
 #pragma pack(0)
 
     struct i2c {
 
+    public:
+        static constexpr uint8_t Configuration_offset = 10;
+        static constexpr uint8_t Settings_offset = 30;
+        static constexpr uint8_t Apply_offset = offsetof(reg_info_t, apply);
+        static constexpr uint8_t Home_offset = offsetof(reg_info_t, home);
+        static constexpr uint8_t Telemetry_offset = 170;
+        static constexpr uint8_t Pitch_offset = 180;
+        static constexpr uint8_t Motion_offset = 200;
+        static constexpr uint8_t Carriage_offset = 220;
+        static constexpr uint8_t Events_offset = 240;
+        // the backlash is added to a burst, which counts pulses in 8 bits
+        static constexpr uint8_t Max_backlash = 0xFF - step_gen::Max_burst;
+        // largest term of the reduced step ratio, the step ISR works in 16 bits
+        static constexpr uint32_t Max_ratio_term = 0xFFFF;
+
     private:
         volatile static inline char dma_buffer[16];
+        volatile static inline uintptr_t tx_address = 0; // next byte of a read
+        volatile static inline uint8_t tx_count = 0; // bytes of the read sent so far
+        volatile static inline uint8_t apply_requests = 0; // bumped by writes to apply
 
-        static uint32_t get_address(uint8_t offset) {
+        static uintptr_t get_address(uint8_t offset) {
+            if (offset >= Events_offset) {
+                return (uintptr_t)&reg_event + offset - Events_offset;
+            }
+            if (offset >= Carriage_offset) {
+                return (uintptr_t)&reg_carriage + offset - Carriage_offset;
+            }
+            if (offset >= Motion_offset) {
+                return (uintptr_t)&reg_motion + offset - Motion_offset;
+            }
+            if (offset >= Pitch_offset) {
+                return (uintptr_t)&reg_pitch + offset - Pitch_offset;
+            }
+            if (offset >= Telemetry_offset) {
+                return (uintptr_t)&reg_telemetry + offset - Telemetry_offset;
+            }
+            if (offset >= 140) {
+                return (uintptr_t)&reg_position + offset - 140;
+            }
+            if (offset >= 70) {
+                return (uintptr_t)&reg_perf + offset - 70;
+            }
             if (offset >= 50) {
-                return (uint32_t)&reg_state + offset - 50;
+                return (uintptr_t)&reg_state + offset - 50;
             }
-            if (offset >= 30) {
-                return (uint32_t)&reg_settings + offset - 30;
+            if (offset >= Settings_offset) {
+                return (uintptr_t)&reg_settings + offset - Settings_offset;
             }
-            if (offset >= 10) {
-                return (uint32_t)&reg_configuration + offset - 10;
+            if (offset >= Configuration_offset) {
+                return (uintptr_t)&reg_configuration + offset - Configuration_offset;
             }
-            return (uint32_t)&reg_info + offset;
+            return (uintptr_t)&reg_info + offset;
+        }
+
+        // Where a written byte goes, nullptr outside the shadow banks
+        static volatile char* get_shadow_address(uint8_t offset) {
+            if (offset >= Motion_offset && offset < Motion_offset + sizeof(reg_motion_t)) {
+                return reinterpret_cast<volatile char*>(&shadow_motion) + offset - Motion_offset;
+            }
+            if (offset >= Pitch_offset && offset < Pitch_offset + sizeof(reg_pitch_t)) {
+                return reinterpret_cast<volatile char*>(&shadow_pitch) + offset - Pitch_offset;
+            }
+            if (offset >= Settings_offset && offset < Settings_offset + sizeof(reg_settings_t)) {
+                return reinterpret_cast<volatile char*>(&shadow_settings) + offset - Settings_offset;
+            }
+            if (offset >= Configuration_offset && offset < Configuration_offset + sizeof(reg_configuration_t)) {
+                return reinterpret_cast<volatile char*>(&shadow_configuration) + offset - Configuration_offset;
+            }
+            return nullptr;
         }
 
         static void rx_complete() {
             DMA1->IFCR |= DMA_IFCR_CTCIF5;
-            DMA1->IFCR |= DMA_IFCR_CTCIF4;
             DMA1_Channel5->CCR &= ~DMA_CCR_EN;
-            DMA1_Channel4->CCR &= ~DMA_CCR_EN;
 
             auto len = 16 - DMA1_Channel5->CNDTR;
             if (len == 1) {
                 // prepare for a read
                 reg_state.rpm = rpm_counter<>::get_rpm(reg_configuration.encoder_resolution);
+                reg_state.speed = rpm_counter<>::get_decirpm(reg_configuration.encoder_resolution);
+                reg_state.acceleration = rpm_counter<>::get_acceleration(reg_configuration.encoder_resolution);
                 reg_state.pos = encoder::get_count();
-            } else {
-                // perform a write
-                uint32_t dest = get_address(dma_buffer[0]);
-                len--;
-                auto incr = sizeof(char);
-                for (auto i = 0; i < len; i++) {
-                    *((char*)(uintptr_t)dest) = dma_buffer[i + 1];
-                    dest += incr;
+                reg_state.glitches = encoder::glitches;
+                reg_state.input_filter = encoder::filter;
+                reg_info.home = home::status();
+                uint8_t offset = dma_buffer[0];
+                if (offset == Events_offset) {
+                    events::pop(reg_event);
+                } else if (offset >= Carriage_offset && offset < Events_offset) {
+                    read_carriage();
+                } else if (offset >= Telemetry_offset && offset < Pitch_offset) {
+                    reg_telemetry.overflows = telemetry::overflows;
+                } else if (offset >= 140 && offset < Telemetry_offset) {
+                    read_position();
+                } else if (offset >= 70 && offset < 140) {
+                    perf::read(reg_perf.handlers);
                 }
+            } else {
+                write(dma_buffer[0], &dma_buffer[1], len - 1);
             }
             dma_buffer[0] = 0x0;
         }
 
+        // Offset of the first invalid field in the shadow banks, 0 when they can be applied
+        static uint8_t validate() {
+            auto& c = shadow_configuration;
+            auto& s = shadow_settings;
+            auto& p = shadow_pitch;
+            auto& m = shadow_motion;
+            auto configuration = [](size_t field) { return static_cast<uint8_t>(Configuration_offset + field); };
+            auto settings = [](size_t field) { return static_cast<uint8_t>(Settings_offset + field); };
+            auto pitch = [](size_t field) { return static_cast<uint8_t>(Pitch_offset + field); };
+            auto motion = [](size_t field) { return static_cast<uint8_t>(Motion_offset + field); };
+            if (c.encoder_resolution == 0 || c.encoder_resolution != resolution::encoder(c.encoder_resolution)) {
+                return configuration(offsetof(reg_configuration_t, encoder_resolution));
+            }
+            if (c.stepper_resolution == 0 || c.stepper_resolution != resolution::stepper(c.stepper_resolution)) {
+                return configuration(offsetof(reg_configuration_t, stepper_resolution));
+            }
+            if (c.stepper_pulse_length_ns == 0) {
+                return configuration(offsetof(reg_configuration_t, stepper_pulse_length_ns));
+            }
+            if (c.max_velocity == 0) {
+                return configuration(offsetof(reg_configuration_t, max_velocity));
+            }
+            if (c.max_acceleration == 0) {
+                return configuration(offsetof(reg_configuration_t, max_acceleration));
+            }
+            if (c.thread_starts != 0 && c.thread_start >= c.thread_starts) {
+                return configuration(offsetof(reg_configuration_t, thread_start));
+            }
+            if (c.rpm_update_ms == 0) {
+                return configuration(offsetof(reg_configuration_t, rpm_update_ms));
+            }
+            if (s.mode > 0x2) {
+                return settings(offsetof(reg_settings_t, mode));
+            }
+            if (s.preset > constants::pitch_preset_count) {
+                return settings(offsetof(reg_settings_t, preset));
+            }
+            if (p.pitch_num == 0) {
+                return pitch(offsetof(reg_pitch_t, pitch_num));
+            }
+            if (p.pitch_denom == 0) {
+                return pitch(offsetof(reg_pitch_t, pitch_denom));
+            }
+            if (p.leadscrew_num == 0 || p.leadscrew_num != leadscrew::num(p.leadscrew_num)) {
+                return pitch(offsetof(reg_pitch_t, leadscrew_num));
+            }
+            if (p.leadscrew_denom == 0 || p.leadscrew_denom != leadscrew::denom(p.leadscrew_denom)) {
+                return pitch(offsetof(reg_pitch_t, leadscrew_denom));
+            }
+            uint32_t steps, counts;
+            if (!step_ratio(c, p, steps, counts)) {
+                return pitch(offsetof(reg_pitch_t, pitch_denom));
+            }
+            if (!burst_fits(steps, counts)) {
+                return pitch(offsetof(reg_pitch_t, pitch_num));
+            }
+            if (s.move > 0x2) {
+                return settings(offsetof(reg_settings_t, move));
+            }
+            if (s.acceleration == 0) {
+                return settings(offsetof(reg_settings_t, acceleration));
+            }
+            if (m.backlash > Max_backlash) {
+                return motion(offsetof(reg_motion_t, backlash));
+            }
+            if (m.limits > 0x3) {
+                return motion(offsetof(reg_motion_t, limits));
+            }
+            if (m.limits == 0x3 && m.left_limit >= m.right_limit) {
+                return motion(offsetof(reg_motion_t, right_limit));
+            }
+            return 0;
+        }
+
+        static void copy(volatile void* dest, const volatile void* src, size_t size) {
+            auto d = static_cast<volatile char*>(dest);
+            auto s = static_cast<const volatile char*>(src);
+            for (size_t i = 0; i < size; i++) {
+                d[i] = s[i];
+            }
+        }
+
+        // Both positions from the same encoder wrap
+        static void read_position() {
+            int64_t spindle, leadscrew;
+            uint8_t g;
+            do {
+                g = encoder::get_generation();
+                spindle = encoder::get_extended_count();
+                leadscrew = step_gen::get_position();
+            } while (g != encoder::get_generation());
+            reg_position.spindle_count = spindle;
+            reg_position.leadscrew_position = leadscrew;
+            reg_position.index_count = encoder::get_index_count();
+        }
+
+        static void read_carriage() {
+            int64_t position;
+            uint8_t g;
+            do {
+                g = encoder::get_generation();
+                position = step_gen::get_carriage_position();
+            } while (g != encoder::get_generation());
+            reg_carriage.position = position;
+            reg_carriage.position_um = micrometres(position);
+            reg_carriage.home_angle = home::angle;
+        }
+
         static void rx_start() {
+            I2C2->SR1 &= ~I2C_SR1_AF; // left over from the NACK ending a read
+            I2C2->CR2 &= ~I2C_CR2_ITBUFEN;
+            I2C2->CR2 |= I2C_CR2_DMAEN;
             DMA1_Channel5->CCR &= ~DMA_CCR_EN;
-            DMA1_Channel4->CCR &= ~DMA_CCR_EN;
             DMA1_Channel5->CNDTR = 16; // length of data to expect
-            DMA1_Channel5->CMAR = (uint32_t)&dma_buffer; // dest
+            DMA1_Channel5->CMAR = (uintptr_t)&dma_buffer; // dest
             DMA1_Channel5->CCR |= DMA_CCR_EN;
         }
 
+        // Reads are sent a byte at a time from the TXE interrupt. DMA1 channel 4,
+        // the I2C2 TX request, belongs to the UART, so DMA requests are off while
+        // transmitting.
         static void tx_start() {
+            I2C2->SR1 &= ~I2C_SR1_AF;
             DMA1_Channel5->CCR &= ~DMA_CCR_EN;
-            DMA1_Channel4->CCR &= ~DMA_CCR_EN;
-            DMA1_Channel4->CMAR = get_address(dma_buffer[0]);
-            DMA1_Channel4->CNDTR = 16;
-            DMA1_Channel4->CCR |= DMA_CCR_EN;
+            I2C2->CR2 &= ~I2C_CR2_DMAEN;
+            tx_address = get_address(dma_buffer[0]);
+            tx_count = 0;
+            I2C2->CR2 |= I2C_CR2_ITBUFEN;
+        }
+
+        static void tx_next() {
+            uint8_t n = tx_count;
+            // the master ends the read with a NACK, past 16 bytes it only gets padding
+            I2C2->DR = n < 16 ? *reinterpret_cast<volatile char*>(tx_address + n) : 0xFF;
+            tx_count = n + 1;
         }
 
     public:
         // offset 0 - reserve 10
         volatile static inline reg_info_t reg_info = {
-            .version = version
+            .version = version,
+            .apply = 0,
+            .generation = 0,
+            .rejected = 0,
+            .home = 0
         };
 
-        // offset 10 - reserve 20
-        volatile static inline reg_configuration_t reg_configuration = {
-            .encoder_resolution = 2400u,
-            .stepper_resolution = 200u * 10,
+        // Writes to CONFIGURATION, SETTINGS, PITCH and MOTION land in these and are copied
+        // over the live registers by apply(), reads return the live registers
+        static constexpr reg_configuration_t default_configuration = {
+            .encoder_resolution = resolution::encoder(2400u),
+            .stepper_resolution = resolution::stepper(200u * 10),
             .stepper_pulse_length_ns = 2500,
             .stepper_change_dwell_ns = 5000,
-            .stepper_flags = 0x2
+            .stepper_flags = 0x2,
+            .max_velocity = 20000,
+            .max_acceleration = 40000,
+            .thread_starts = 0,
+            .thread_start = 0,
+            .rpm_update_ms = 4
         };
-        // offset 30 - reserve 20
-        volatile static inline reg_settings_t reg_settings = {
+        static constexpr reg_settings_t default_settings = {
             .mode = 0,
-            .gear_num = 1,
-            .gear_denom = 1
+            .preset = 0,
+            .reserved = 0,
+            .target = 0,
+            .move = 0,
+            .feed_velocity = 2000,
+            .rapid_velocity = 20000,
+            .acceleration = 40000
         };
+        static constexpr reg_pitch_t default_pitch = {
+            .pitch_num = 1,
+            .pitch_denom = 1,
+            .leadscrew_num = leadscrew::num(2u),
+            .leadscrew_denom = leadscrew::denom(1u)
+        };
+        volatile static inline reg_configuration_t shadow_configuration = default_configuration;
+        volatile static inline reg_settings_t shadow_settings = default_settings;
+        volatile static inline reg_pitch_t shadow_pitch = default_pitch;
+        volatile static inline reg_motion_t shadow_motion = {};
+
+        // offset 10 - reserve 20
+        volatile static inline reg_configuration_t reg_configuration = default_configuration;
+        // offset 30 - reserve 20
+        volatile static inline reg_settings_t reg_settings = default_settings;
         // offset 50 - reserve 20
         volatile static inline reg_state_t reg_state = {
             .rpm = 0,
-            .pos = 0
+            .pos = 0,
+            .control = 0,
+            .speed = 0,
+            .acceleration = 0,
+            .glitches = 0,
+            .input_filter = 0,
+            .limit = 0
         };
+        // offset 70 - reserve 70, read only
+        volatile static inline reg_perf_t reg_perf = {};
+        // offset 140 - reserve 30, read only
+        volatile static inline reg_position_t reg_position = {};
+        // offset 170 - reserve 10
+        volatile static inline reg_telemetry_t reg_telemetry = {};
+        // offset 180 - reserve 20
+        volatile static inline reg_pitch_t reg_pitch = default_pitch;
+        // offset 200 - reserve 20
+        volatile static inline reg_motion_t reg_motion = {};
+        // offset 220 - reserve 20, read only
+        volatile static inline reg_carriage_t reg_carriage = {};
+        // offset 240 - reserve 16, read only, a read from its start pops the oldest event
+        volatile static inline event_record_t reg_event = {};
+
+        // Length of a number of leadscrew steps in micrometres for a leadscrew
+        // pitch in mm, while steps * leadscrew_num * 1000 fits 64 bits
+        static int32_t micrometres(int64_t steps) {
+            int64_t num = leadscrew::num(reg_pitch.leadscrew_num);
+            int64_t denom = int64_t{ leadscrew::denom(reg_pitch.leadscrew_denom) }
+                * resolution::stepper(reg_configuration.stepper_resolution);
+            return static_cast<int32_t>(steps * num * 1000 / denom);
+        }
+
+        // Steps per encoder count for the pitch as an exact, fully reduced
+        // fraction. Each term is cancelled against each term of the other side
+        // first, so nothing wider than 64 bits is needed. Returns false when a
+        // term of the result is larger than Max_ratio_term.
+        static bool step_ratio(const volatile reg_configuration_t& c, const volatile reg_pitch_t& p,
+            uint32_t& steps, uint32_t& counts) {
+            return step_ratio(p.pitch_num, p.pitch_denom, leadscrew::num(p.leadscrew_num), leadscrew::denom(p.leadscrew_denom),
+                resolution::stepper(c.stepper_resolution), resolution::encoder(c.encoder_resolution), steps, counts);
+        }
+
+        static constexpr bool step_ratio(uint32_t pitch_num, uint32_t pitch_denom, uint32_t leadscrew_num, uint32_t leadscrew_denom,
+            uint32_t stepper, uint32_t encoder, uint32_t& steps, uint32_t& counts) {
+            uint64_t n[3] = { pitch_num, leadscrew_denom, stepper };
+            uint64_t d[3] = { pitch_denom, leadscrew_num, encoder };
+            for (auto& a : n) {
+                for (auto& b : d) {
+                    uint64_t g = std::gcd(a, b);
+                    if (g > 1) {
+                        a /= g;
+                        b /= g;
+                    }
+                }
+            }
+            uint64_t num = 1, denom = 1;
+            for (uint8_t i = 0; i < 3; i++) {
+                if (__builtin_mul_overflow(num, n[i], &num) || __builtin_mul_overflow(denom, d[i], &denom)) {
+                    return false;
+                }
+            }
+            if (num > Max_ratio_term || denom > Max_ratio_term) {
+                return false;
+            }
+            steps = num;
+            counts = denom;
+            return true;
+        }
+
+        // Above one step per encoder count the jumps issue bursts, and the
+        // gear counts in units of a burst
+        static constexpr bool burst_fits(uint32_t steps, uint32_t counts) {
+            uint32_t burst = (steps + counts - 1) / counts;
+            return burst <= step_gen::Max_burst && counts * burst <= Max_ratio_term;
+        }
 
         static void init() {
 
@@ -147,16 +536,10 @@ namespace devices {
 
             // Set up DMA for RX
             DMA1_Channel5->CCR &= ~(DMA_CCR_EN | DMA_CCR_PINC_Msk | DMA_CCR_MSIZE_Msk | DMA_CCR_PSIZE_Msk | DMA_CCR_CIRC_Msk | DMA_CCR_DIR_Msk);
-            DMA1_Channel5->CPAR = (uint32_t)&I2C2->DR; // source
+            DMA1_Channel5->CPAR = (uintptr_t)&I2C2->DR; // source
             DMA1_Channel5->CCR |= DMA_CCR_MINC; // memory increment mode
             DMA1_Channel5->CCR |= DMA_CCR_TCIE; // transfer complete interrupt enable
 
-            // Set up DMA for TX - CMAR and CNDTR are set later
-            DMA1_Channel4->CCR &= ~(DMA_CCR_EN | DMA_CCR_PINC_Msk | DMA_CCR_MSIZE_Msk | DMA_CCR_PSIZE_Msk | DMA_CCR_CIRC_Msk);
-            DMA1_Channel4->CPAR = (uint32_t)&I2C2->DR; // dest
-            DMA1_Channel4->CCR |= DMA_CCR_MINC; // memory increment mode
-            DMA1_Channel4->CCR |= DMA_CCR_DIR; // from memory to peripheral
-
             // Configure I2C
             I2C2->CR1 &= ~I2C_CR1_PE; // disable
             I2C2->CR1 |= I2C_CR1_SWRST; // reset
@@ -177,6 +560,59 @@ namespace devices {
             NVIC_EnableIRQ(I2C2_EV_IRQn);
         }
 
+        // A register write, from the I2C interrupts. Only CONFIGURATION,
+        // SETTINGS, PITCH, apply and the telemetry decimation can be written,
+        // the rest is dropped.
+        static void write(uint8_t offset, const volatile char* data, uint8_t len) {
+            for (uint8_t i = 0; i < len; i++) {
+                uint8_t o = offset + i;
+                if (auto dest = get_shadow_address(o)) {
+                    *dest = data[i];
+                } else if (o == Apply_offset && data[i] != 0) {
+                    apply_requests = apply_requests + 1;
+                } else if (o == Home_offset) {
+                    home::command(data[i]);
+                } else if (o == Telemetry_offset) {
+                    reg_telemetry.decimation = data[i];
+                }
+            }
+        }
+
+        static uint8_t get_apply_requests() {
+            return apply_requests;
+        }
+
+        // Validate the shadow banks and copy them over the live registers,
+        // main loop only. A move is a command, it is taken from the shadow
+        // once so applying again does not repeat it.
+        static bool apply() {
+            NVIC_DisableIRQ(DMA1_Channel5_IRQn);
+            NVIC_DisableIRQ(I2C2_EV_IRQn);
+            uint8_t preset = shadow_settings.preset;
+            if (preset != 0 && preset <= constants::pitch_preset_count) {
+                // checked and applied as if written to PITCH
+                shadow_pitch.pitch_num = constants::pitch_presets[preset - 1].num;
+                shadow_pitch.pitch_denom = constants::pitch_presets[preset - 1].denom;
+            }
+            uint8_t rejected = validate();
+            if (rejected == 0) {
+                uint8_t move = shadow_settings.move;
+                if (move == 0) {
+                    shadow_settings.move = reg_settings.move; // keep a move that has not started yet
+                }
+                copy(&reg_configuration, &shadow_configuration, sizeof(reg_configuration_t));
+                copy(&reg_settings, &shadow_settings, sizeof(reg_settings_t));
+                copy(&reg_pitch, &shadow_pitch, sizeof(reg_pitch_t));
+                copy(&reg_motion, &shadow_motion, sizeof(reg_motion_t));
+                shadow_settings.move = 0;
+                reg_info.generation = reg_info.generation + 1;
+            }
+            reg_info.rejected = rejected;
+            NVIC_EnableIRQ(I2C2_EV_IRQn);
+            NVIC_EnableIRQ(DMA1_Channel5_IRQn);
+            return rejected == 0;
+        }
+
         // RX
         static void DMA1_Channel5_IRQHandler() {
             if (DMA1->ISR & DMA_ISR_TCIF5) {
@@ -193,6 +629,10 @@ namespace devices {
                 }
             }
 
+            if ((I2C2->CR2 & I2C_CR2_ITBUFEN) && (I2C2->SR1 & I2C_SR1_TXE)) {
+                tx_next();
+            }
+
             if (I2C2->SR1 & I2C_SR1_STOPF) {
                 // clear the bit
                 I2C2->CR1 |= I2C_CR1_ACK;
@@ -203,4 +643,4 @@ namespace devices {
             }
         }
     };
-}
\ No newline at end of file
+}
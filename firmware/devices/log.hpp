@@ -0,0 +1,54 @@
+#pragma once
+#include <cstring>
+#include "log_format.hpp"
+#include "uart.hpp"
+
+namespace devices {
+
+    // Binary event log, from the main loop or any interrupt. An event is
+    // packed into a frame on the stack and copied into the UART buffer, a
+    // frame that does not fit is dropped and counted.
+    struct log {
+        using event = log_format::event;
+
+        volatile static inline uint16_t dropped = 0; // since the last overflow event
+
+        template <typename... Fields>
+        static void write(event e, Fields... fields) {
+            uint8_t payload[(sizeof(Fields) + ... + 0) + 1];
+            uint8_t size = 0;
+            ((std::memcpy(&payload[size], &fields, sizeof(Fields)), size += sizeof(Fields)), ...);
+            send(e, payload, size);
+        }
+
+        static void text(const char* s) {
+            send(event::text, s, strnlen(s, log_format::Max_payload));
+        }
+
+    private:
+        static bool frame(event e, const void* payload, uint8_t size) {
+            uint8_t f[log_format::Max_payload + 4];
+            auto p = static_cast<const uint8_t*>(payload);
+            uint8_t sum = static_cast<uint8_t>(e) + size;
+            f[0] = log_format::Sync;
+            f[1] = static_cast<uint8_t>(e);
+            f[2] = size;
+            for (uint8_t i = 0; i < size; i++) {
+                f[3 + i] = p[i];
+                sum += p[i];
+            }
+            f[3 + size] = sum;
+            return uart::write(f, size + 4);
+        }
+
+        static void send(event e, const void* payload, uint8_t size) {
+            uint16_t d = dropped;
+            if (d != 0 && frame(event::overflow, &d, sizeof(d))) {
+                dropped = dropped - d;
+            }
+            if (!frame(e, payload, size)) {
+                dropped = dropped + 1;
+            }
+        }
+    };
+}
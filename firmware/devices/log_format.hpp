@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+
+namespace devices {
+
+    // Log frames on the UART, shared with the host decoder in tools/:
+    //   Sync, event, payload length, payload, checksum
+    // The checksum is the low byte of the sum of event, length and payload,
+    // multi-byte fields are little endian.
+    namespace log_format {
+        constexpr uint8_t Sync = 0xA5;
+        constexpr uint8_t Max_payload = 32;
+
+        enum class event : uint8_t {
+            overflow = 1, // uint16_t frames dropped while the buffer was full
+            text, // characters
+            gear_changed, // uint32_t pitch_num, uint32_t pitch_denom, uint16_t steps, uint16_t counts
+            mode_set, // uint8_t mode
+            register_rejected, // uint8_t offset
+            control_changed, // uint8_t state
+            thread_engaged, // uint16_t encoder count
+            telemetry, // telemetry_record_t
+            limit_reached, // uint8_t limit, 1 left or 2 right
+            home_set, // uint16_t spindle angle in encoder counts past the index, 0xFFFF before the index
+        };
+    }
+
+    // A record of one jump of the step ISR, see devices/telemetry.hpp
+#pragma pack(1)
+    typedef struct {
+        uint16_t sequence; // jumps since telemetry was enabled, gaps are decimation or overflow
+        uint16_t count; // encoder count
+        int32_t error; // gear error after the jump, in 1/D steps
+        uint16_t delay; // phase delay of the step in TIM3 ticks, 0 for manual pulses
+        uint16_t period; // last_full_period
+        uint8_t flags; // telemetry::Forward, ...
+    } telemetry_record_t;
+#pragma pack(0)
+}
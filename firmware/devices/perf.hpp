@@ -0,0 +1,108 @@
+#pragma once
+#include "stm32f103xb.h"
+
+namespace devices {
+
+    // Per handler timing, as read from the PERF registers
+#pragma pack(1)
+    typedef struct {
+        uint16_t min_cycles;
+        uint16_t max_cycles;
+        uint16_t mean_cycles; // running mean over roughly the last 16 calls
+        uint16_t preemptions; // times another instrumented handler interrupted this one
+        uint16_t histogram[4]; // calls taking <128, <256, <512 and >=512 cycles
+    } perf_record_t;
+#pragma pack(0)
+
+#ifdef MELS_PERF
+    struct perf_counters {
+        uint16_t min = std::numeric_limits<uint16_t>::max();
+        uint16_t max = 0;
+        uint32_t mean = 0; // scaled by 2^perf::Mean_shift
+        uint16_t preemptions = 0;
+        uint16_t histogram[4] = {};
+    };
+#endif
+
+    // Handler profiling with the DWT cycle counter, enabled with MELS_PERF.
+    // A handler opens a perf::scope on entry; the cycles counted run until the
+    // scope closes, including time spent in handlers that preempted it.
+    struct perf {
+        enum handler : uint8_t {
+            tim1_cc,
+            tim3,
+            i2c2_ev,
+            systick,
+            handler_count
+        };
+
+        static constexpr uint8_t Mean_shift = 4; // running mean over 2^Mean_shift calls
+
+#ifdef MELS_PERF
+    private:
+        volatile static inline perf_counters handlers[handler_count];
+        volatile static inline uint8_t active = handler_count; // innermost open scope
+
+        static inline void record(handler h, uint32_t elapsed) {
+            auto& c = handlers[h];
+            uint16_t e = elapsed > std::numeric_limits<uint16_t>::max() ? std::numeric_limits<uint16_t>::max() : elapsed;
+            if (e < c.min) {
+                c.min = e;
+            }
+            if (e > c.max) {
+                c.max = e;
+            }
+            c.mean = c.mean ? c.mean + e - (c.mean >> Mean_shift) : e << Mean_shift;
+            uint8_t bin = e < 128 ? 0 : e < 256 ? 1 : e < 512 ? 2 : 3;
+            c.histogram[bin] = c.histogram[bin] + 1;
+        }
+
+    public:
+        struct scope {
+            const handler h;
+            const uint8_t outer;
+            const uint32_t start;
+
+            scope(handler h) : h(h), outer(active), start(DWT->CYCCNT) {
+                if (outer != handler_count) {
+                    handlers[outer].preemptions = handlers[outer].preemptions + 1;
+                }
+                active = h;
+            }
+
+            ~scope() {
+                uint32_t elapsed = DWT->CYCCNT - start;
+                active = outer;
+                record(h, elapsed);
+            }
+        };
+
+        static void init() {
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // enable the trace and debug blocks
+            DWT->CYCCNT = 0;
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; // start the cycle counter
+        }
+
+        static void read(volatile perf_record_t* dest) {
+            for (uint8_t i = 0; i < handler_count; i++) {
+                volatile auto& c = handlers[i];
+                dest[i].min_cycles = c.max ? c.min : 0;
+                dest[i].max_cycles = c.max;
+                dest[i].mean_cycles = c.mean >> Mean_shift;
+                dest[i].preemptions = c.preemptions;
+                for (uint8_t b = 0; b < 4; b++) {
+                    dest[i].histogram[b] = c.histogram[b];
+                }
+            }
+        }
+#else
+        struct scope {
+            scope(handler) {}
+        };
+
+        static void init() {}
+
+        static void read(volatile perf_record_t*) {}
+#endif
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <stdint.h>
+
+namespace devices {
+
+    // Where the encoder and stepper resolutions come from. By default they
+    // are the CONFIGURATION registers. A build for fixed hardware bakes them
+    // in (ENCODER= and STEPPER= in the Makefile), so the arithmetic on them
+    // is done by the compiler and CONFIGURATION only accepts those values.
+    struct configured_resolution {
+        static constexpr bool fixed = false;
+
+        static constexpr uint16_t encoder(uint16_t configured) {
+            return configured;
+        }
+
+        static constexpr uint16_t stepper(uint16_t configured) {
+            return configured;
+        }
+    };
+
+    template <uint16_t Encoder, uint16_t Stepper>
+    struct fixed_resolution {
+        static_assert(Encoder != 0 && Stepper != 0, "resolutions must not be 0");
+        static constexpr bool fixed = true;
+
+        static constexpr uint16_t encoder(uint16_t) {
+            return Encoder;
+        }
+
+        static constexpr uint16_t stepper(uint16_t) {
+            return Stepper;
+        }
+    };
+
+#if defined(MELS_ENCODER_RESOLUTION) && defined(MELS_STEPPER_RESOLUTION)
+    using resolution = fixed_resolution<MELS_ENCODER_RESOLUTION, MELS_STEPPER_RESOLUTION>;
+#elif defined(MELS_ENCODER_RESOLUTION) || defined(MELS_STEPPER_RESOLUTION)
+#error "set both ENCODER and STEPPER for a fixed resolution build"
+#else
+    using resolution = configured_resolution;
+#endif
+
+    // The leadscrew pitch in PITCH likewise (LEADSCREW_NUM= and
+    // LEADSCREW_DENOM=), with the resolutions it lets the compiler reduce
+    // the pitch presets
+    struct configured_leadscrew {
+        static constexpr bool fixed = false;
+
+        static constexpr uint32_t num(uint32_t configured) {
+            return configured;
+        }
+
+        static constexpr uint32_t denom(uint32_t configured) {
+            return configured;
+        }
+    };
+
+    template <uint32_t Num, uint32_t Denom>
+    struct fixed_leadscrew {
+        static_assert(Num != 0 && Denom != 0, "leadscrew pitch terms must not be 0");
+        static constexpr bool fixed = true;
+
+        static constexpr uint32_t num(uint32_t) {
+            return Num;
+        }
+
+        static constexpr uint32_t denom(uint32_t) {
+            return Denom;
+        }
+    };
+
+#if defined(MELS_LEADSCREW_NUM) && defined(MELS_LEADSCREW_DENOM)
+    using leadscrew = fixed_leadscrew<MELS_LEADSCREW_NUM, MELS_LEADSCREW_DENOM>;
+#elif defined(MELS_LEADSCREW_NUM)
+    using leadscrew = fixed_leadscrew<MELS_LEADSCREW_NUM, 1>;
+#else
+    using leadscrew = configured_leadscrew;
+#endif
+}
@@ -1,47 +1,131 @@
-
 #pragma once
 #include "stm32f103xb.h"
+#include "resolution.hpp"
 
 namespace devices {
 
-    template <uint8_t Period_ms = 10, uint8_t Samples = 16>
+    // Spindle speed from the encoder count sampled every millisecond.
+    //
+    // At speed the count delta over the last History ms is used. Below
+    // Min_counts in that window the speed comes from the time between the
+    // first and the last of the recent encoder edges instead (M/T method),
+    // so slow spindles get a reading without waiting for counts to pile up.
+    // The edges are timed by the sample that sees them, to 1 ms, which
+    // limits that reading to 1 ms over the span of the edges. Speeds are kept in counts/s with 8 fractional bits, positive
+    // when the count goes up. The conversions to rpm take the configured
+    // encoder resolution, which Resolution may replace with a constant.
+    template <uint8_t History = 64, uint8_t Edges = 32, typename Resolution = resolution>
 
     struct rpm_counter {
-        static constexpr uint16_t periods_per_min = 60000 / Period_ms;
-        static constexpr uint8_t Sampling_period = Period_ms;
+        static constexpr uint16_t Min_counts = 32; // below this the edge times are used
+        static constexpr uint16_t Max_span_ms = 1000; // oldest edge used
+        static constexpr uint16_t Stop_ms = 500; // no edge for this long reads as stopped
+
+        struct edge {
+            uint32_t time; // ms
+            uint32_t position;
+        };
 
         volatile inline static uint16_t last_reading = 0;
-        volatile inline static uint8_t sample_index = 0;
-        volatile inline static unsigned running_sum = 0;
-        volatile inline static uint16_t sum = 0;
-
-        static inline uint16_t convert_sample(uint16_t c) {
-            auto p = last_reading;
-            uint16_t d = (c > p) ? (c - p) : (p - c);
-            if (d > std::numeric_limits<uint16_t>::max() / 2) {
-                d = std::numeric_limits<uint16_t>::max() - d;
-            }
-            last_reading = c;
-            return d;
+        volatile inline static uint32_t position = 0; // counts, wraps
+        volatile inline static uint32_t time = 0; // ms since start
+        volatile inline static uint32_t samples[History] = {};
+        volatile inline static edge edges[Edges] = {};
+        volatile inline static uint8_t edge_count = 0; // edges recorded, up to Edges
+        volatile inline static uint8_t edge_index = 0; // newest edge
+        volatile inline static uint32_t updated = 0; // time of the last update
+        volatile inline static int32_t speed = 0; // counts/s, 8 fractional bits
+        volatile inline static int32_t acceleration = 0; // counts/s^2, 8 fractional bits
+
+        // Every ms, from SysTick
+        static void process_sample(uint16_t current_reading) {
+            int16_t d = current_reading - last_reading;
+            last_reading = current_reading;
+            uint32_t p = position + d;
+            uint32_t t = time + 1;
+            position = p;
+            time = t;
+            samples[t % History] = p;
+            if (d != 0) {
+                uint8_t i = (edge_index + 1) % Edges;
+                edges[i].time = t;
+                edges[i].position = p;
+                edge_index = i;
+                if (edge_count < Edges) {
+                    edge_count = edge_count + 1;
+                }
+            }
         }
 
-        static bool process_sample(uint16_t current_reading) {
-            running_sum += convert_sample(current_reading);
-            auto i = sample_index;
-            if ((++i) == Samples) {
-                sum = running_sum;
-                sample_index = 0;
-                running_sum = 0;
-                return true;
-            } else {
-                sample_index = i;
-                return false;
+        // Recompute the estimates, from SysTick after process_sample()
+        static void update() {
+            uint32_t t = time;
+            int32_t s = estimate(t);
+            uint32_t dt = t - updated;
+            if (updated != 0 && dt != 0) {
+                int32_t a = (static_cast<int64_t>(s) - speed) * 1000 / dt;
+                acceleration = acceleration + (a - acceleration) / 8; // smooth the differentiation noise
             }
+            speed = s;
+            updated = t;
+        }
+
+        static uint32_t get_counts_per_second() {
+            int32_t s = speed;
+            return (s < 0 ? -s : s) >> 8;
+        }
+
+        // In 0.1 rpm
+        static int32_t get_decirpm(uint16_t encoder_resolution) {
+            return static_cast<int64_t>(speed) * 600 / (Resolution::encoder(encoder_resolution) * 256ll);
+        }
+
+        // In 0.1 rpm/s
+        static int32_t get_acceleration(uint16_t encoder_resolution) {
+            return static_cast<int64_t>(acceleration) * 600 / (Resolution::encoder(encoder_resolution) * 256ll);
         }
 
         static uint16_t get_rpm(uint16_t encoder_resolution) {
-            auto rpm = (sum * periods_per_min) / (encoder_resolution * Samples);
-            return static_cast<uint16_t>(rpm);
+            int32_t rpm = get_decirpm(encoder_resolution) / 10;
+            return static_cast<uint16_t>(rpm < 0 ? -rpm : rpm);
+        }
+
+    private:
+        static int32_t estimate(uint32_t t) {
+            if (t < History) {
+                return 0; // not enough samples yet
+            }
+            int32_t counts = samples[t % History] - samples[(t + 1) % History];
+            if (counts >= Min_counts || counts <= -Min_counts) {
+                return static_cast<int64_t>(counts) * 1000 * 256 / (History - 1);
+            }
+            if (edge_count < 2) {
+                return 0;
+            }
+            const volatile edge& newest = edges[edge_index];
+            uint32_t idle = t - newest.time;
+            if (idle > Stop_ms) {
+                return 0;
+            }
+            // the oldest edge within Max_span_ms of the newest
+            uint8_t i = edge_index;
+            for (uint8_t n = 1; n < edge_count; n++) {
+                uint8_t j = (i + Edges - 1) % Edges;
+                if (newest.time - edges[j].time > Max_span_ms) {
+                    break;
+                }
+                i = j;
+            }
+            uint32_t span = newest.time - edges[i].time;
+            int32_t moved = newest.position - edges[i].position;
+            if (span == 0 || moved == 0) {
+                return 0;
+            }
+            // no edge for longer than the span allows, the spindle is slowing down
+            if (idle * (moved < 0 ? -moved : moved) > span) {
+                span = idle * (moved < 0 ? -moved : moved);
+            }
+            return static_cast<int64_t>(moved) * 1000 * 256 / span;
         }
     };
-}
\ No newline at end of file
+}
@@ -1,3 +1,5 @@
+#pragma once
+#include <cstddef>
 #include "stm32f103xb.h"
 #include "../constants.hpp"
 
@@ -5,10 +7,46 @@ namespace devices {
 
     struct step_gen {
 
-        static constexpr uint64_t ClockFreq = constants::CPU_Clock_Freq_Hz;
+        static constexpr uint64_t ClockFreq = constants::CPU_Clock_Freq_Hz / 2; // APB1 timers run at PCLK1 (HCLK / 4) x 2
         static constexpr uint8_t ClockDiv = 2;
+        static constexpr uint64_t TimerFreq = ClockFreq / ClockDiv;
         static constexpr unsigned int min_count = constants::min_timer_capture_count; // required by timer
         static inline bool enabled = false;
+        static constexpr uint8_t Max_burst = 64; // pulses per trigger
+
+        // Pulses issued for every TIM1 trigger. Above one the first pulse is
+        // timed as a single one and the rest follow every burst_period, with
+        // ARR and CCR3 preloaded, and the update interrupt of each pulse
+        // counts the burst down and stops the timer after its last pulse.
+        volatile static inline uint8_t burst = 1;
+        volatile static inline uint8_t burst_left = 1; // pulses of the current burst still to be counted
+        volatile static inline uint16_t burst_period = 0xFFFF; // timer counts between pulses of a burst
+        volatile static inline bool burst_loaded = false; // TIM3 is set up for bursts
+
+        // Steps since the last fold are kept in 32 bits so the step ISR stays cheap,
+        // fold_position() moves them into the 64 bit base on every TIM1 wrap
+        volatile static inline int32_t position = 0;
+        volatile static inline int64_t position_base = 0;
+
+        // Lost motion between the leadscrew and the carriage, in steps. The nut
+        // is taken to be loaded forward at start, backlash_reverse is the side
+        // it is loaded on now.
+        volatile static inline uint8_t backlash = 0;
+        volatile static inline bool backlash_reverse = false;
+
+        // One DMA burst into TIM3, ARR through CCR3 (RCR, CCR1 and CCR2 are unused)
+        struct train_entry {
+            uint16_t arr, rcr, ccr1, ccr2, ccr3;
+        };
+
+        static constexpr uint8_t Train_length = 16; // entries per half of the buffer
+        static constexpr uint16_t Idle_period = 500; // timer counts of an entry without a pulse
+
+        // Step train fed to TIM3 by DMA, the half not being sent is refilled
+        static inline train_entry train[2 * Train_length];
+        volatile static inline bool train_running = false;
+        volatile static inline uint16_t train_mark = 0; // TIM4 count last added to position
+        volatile static inline uint8_t train_sequence = 0; // bumped whenever train_mark, a fold or a home moves
 
         struct start_stop {
             volatile uint16_t cnt_start{}, cnt_stop{};
@@ -45,8 +83,31 @@ namespace devices {
             TIM3->CCER |= TIM_CCER_CC3E; // Capture/Compare 3 output enable
             TIM3->SR &= ~TIM_SR_UIF_Msk; // Clear the update interrupt flag
             TIM3->DIER |= TIM_DIER_UIE; // Update interrupt enabled
+            TIM3->CR2 |= TIM_CR2_MMS_1 | TIM_CR2_MMS_2; // OC3REF signal is used as trigger output (TRGO)
+
+            // Timer4 counts the step pulses, step trains have no interrupt per step
+            TIM4->SMCR |= TIM_SMCR_TS_1; // Internal Trigger 2 (ITR2), TIM3 TRGO
+            TIM4->SMCR |= TIM_SMCR_SMS_0 | TIM_SMCR_SMS_1 | TIM_SMCR_SMS_2; // External clock mode 1
+            TIM4->CR1 |= TIM_CR1_CEN;
+
+            // DMA writes a burst of TIM3 registers on every update while a train runs
+            TIM3->DCR = (offsetof(TIM_TypeDef, ARR) / 4) << TIM_DCR_DBA_Pos // from ARR
+                | (offsetof(TIM_TypeDef, CCR3) - offsetof(TIM_TypeDef, ARR)) / 4 << TIM_DCR_DBL_Pos; // to CCR3
+            DMA1_Channel3->CPAR = reinterpret_cast<uintptr_t>(std::addressof(TIM3->DMAR));
+            DMA1_Channel3->CMAR = reinterpret_cast<uintptr_t>(std::addressof(train));
+            DMA1_Channel3->CCR &= ~(DMA_CCR_MSIZE |
+                DMA_CCR_PSIZE |
+                DMA_CCR_EN);
+            DMA1_Channel3->CCR |= (0x1 << DMA_CCR_MSIZE_Pos) // 16 bits
+                | (0x1 << DMA_CCR_PSIZE_Pos) // 16 bits
+                | DMA_CCR_MINC // memory increment mode
+                | DMA_CCR_DIR // from memory to peripheral
+                | DMA_CCR_CIRC // circular mode, the halves are refilled in turn
+                | DMA_CCR_PL_1 // high priority
+                | DMA_CCR_HTIE | DMA_CCR_TCIE; // interrupt when either half has been sent
 
             NVIC_EnableIRQ(TIM3_IRQn);
+            NVIC_EnableIRQ(DMA1_Channel3_IRQn); // same priority as TIM3, it steps too
         }
 
         static void configure(unsigned int dir_setup_ns, unsigned int step_pulse_ns,
@@ -65,7 +126,6 @@ namespace devices {
                 GPIOB->ODR &= ~GPIO_ODR_ODR1;
             }
 
-            constexpr uint64_t TimerFreq = ClockFreq / ClockDiv;
             constexpr uint64_t nanosec = constants::onesec_in_ns.count();
             // TODO: implement a range checked version
             uint16_t cnt_setup_delay = std::max(min_count,
@@ -81,6 +141,11 @@ namespace devices {
             return state.direction;
         }
 
+        // A pulse, or a burst, is under way
+        static inline bool is_running() {
+            return TIM3->CR1 & TIM_CR1_CEN;
+        }
+
         static void change_direction(bool new_dir) {
             state.direction = new_dir;
             if (new_dir ^ state.direction_polarity) {
@@ -90,8 +155,16 @@ namespace devices {
             }
 
             TIM3->CCMR2 &= ~TIM_CCMR2_OC3FE_Msk; // output compare 3 fast disable
-            TIM3->CCR3 = state.counts_reverse.cnt_start; // load new capture/compare value
-            TIM3->ARR = state.counts_reverse.cnt_stop; //  load the new reload value
+            load_first_pulse(state.counts_reverse.cnt_start, state.counts_reverse.cnt_stop);
+        }
+
+        // Space the pulses of a burst at the fastest rate the stepper takes,
+        // so a burst is over before the next trigger at any speed it can
+        // follow. From the main loop.
+        static void set_burst_velocity(uint32_t max_velocity) {
+            uint64_t period = max_velocity ? (TimerFreq + max_velocity - 1) / max_velocity : 0xFFFF; // never faster
+            uint64_t shortest = 2u * state.counts_step; // leaves the update interrupt time to stop the last pulse
+            burst_period = period < shortest ? shortest : period > 0xFFFF ? 0xFFFF : period;
         }
 
         static void set_delay(unsigned delay_count) {
@@ -116,20 +189,209 @@ namespace devices {
 
         static inline void process_interrupt() {
             TIM3->SR &= ~TIM_SR_UIF_Msk;
+            uint8_t left = burst_left;
+            if (left > 1) { // more of the burst to come
+                burst_left = --left;
+                if (left == 1) {
+                    TIM3->CR1 |= TIM_CR1_OPM; // stop after the last one
+                }
+                return;
+            }
             setup_next_pulse();
         }
 
+        // Free running: a pulse at the end of every period, the update interrupt
+        // after each pulse sets the period of the one after next (preloaded)
+        static void start_free_running(uint16_t period) {
+            free_running_mode();
+            set_period(period);
+            TIM3->CNT = 0;
+            load_preloaded();
+            TIM3->CR1 |= TIM_CR1_CEN;
+        }
+
+        static inline void set_period(uint16_t period) {
+            TIM3->ARR = period;
+            TIM3->CCR3 = period + 1 - state.counts_step; // PWM mode 2: active from CCR3 to the end of the period
+        }
+
+        // Back to one pulse per TIM1 trigger
+        static void stop_free_running() {
+            TIM3->CR1 &= ~TIM_CR1_CEN;
+            TIM3->CCMR2 &= ~(TIM_CCMR2_OC3M_0 | TIM_CCMR2_OC3M_1); // force inactive, ends a pulse cut short
+            TIM3->CCMR2 |= TIM_CCMR2_OC3M_0 | TIM_CCMR2_OC3M_1; // back to PWM mode 2
+            TIM3->CNT = 0;
+            TIM3->CR1 &= ~TIM_CR1_ARPE;
+            TIM3->CCMR2 &= ~TIM_CCMR2_OC3PE_Msk;
+            TIM3->CR1 |= TIM_CR1_OPM;
+            TIM3->SR &= ~TIM_SR_UIF_Msk;
+            burst_loaded = false;
+            setup_next_pulse();
+            TIM3->SMCR |= TIM_SMCR_SMS_1 | TIM_SMCR_SMS_2; // Trigger mode
+        }
+
+        static inline void clear_interrupt() {
+            TIM3->SR &= ~TIM_SR_UIF_Msk;
+        }
+
+        static inline train_entry train_step(uint16_t period) {
+            return { period, 0, 0, 0, static_cast<uint16_t>(period + 1 - state.counts_step) };
+        }
+
+        static inline train_entry train_idle() {
+            return { Idle_period, 0, 0, 0, std::numeric_limits<uint16_t>::max() }; // compare never reached
+        }
+
+        // Free running with the periods after the first two taken from the
+        // train buffer, which must be filled. The update interrupt stays off,
+        // pulses are counted by TIM4 instead.
+        static void start_train(train_entry first, train_entry second) {
+            TIM3->DIER &= ~TIM_DIER_UIE;
+            free_running_mode();
+            load(first);
+            TIM3->CNT = 0;
+            TIM3->EGR = TIM_EGR_UG; // the first period starts with the counter
+            load(second); // preloaded for the second period
+            DMA1->IFCR |= DMA_IFCR_CHTIF3 | DMA_IFCR_CTCIF3;
+            DMA1_Channel3->CNDTR = 2 * Train_length * sizeof(train_entry) / sizeof(uint16_t); // transfers
+            DMA1_Channel3->CCR |= DMA_CCR_EN;
+            train_mark = TIM4->CNT;
+            train_running = true;
+            TIM3->DIER |= TIM_DIER_UDE; // every update sends the entry for the period after next
+            TIM3->SR &= ~TIM_SR_UIF_Msk;
+            TIM3->CR1 |= TIM_CR1_CEN;
+        }
+
+        // From the DMA interrupt, returns the half that has been sent and may
+        // be refilled, 2 if none has
+        static inline uint8_t train_half_sent() {
+            uint8_t half = DMA1->ISR & DMA_ISR_HTIF3 ? 0 : DMA1->ISR & DMA_ISR_TCIF3 ? 1 : 2;
+            DMA1->IFCR |= half == 0 ? DMA_IFCR_CHTIF3 : DMA_IFCR_CTCIF3;
+            fold_train();
+            return half;
+        }
+
+        // From the DMA interrupt, or with it and TIM1_UP masked
+        static void stop_train() {
+            TIM3->DIER &= ~TIM_DIER_UDE;
+            DMA1_Channel3->CCR &= ~DMA_CCR_EN;
+            stop_free_running();
+            fold_train();
+            train_running = false;
+            TIM3->DIER |= TIM_DIER_UIE;
+        }
+
+        // Must not be preempted by the step interrupt
+        static inline void fold_position() {
+            position_base = position_base + position;
+            position = 0;
+            train_sequence = train_sequence + 1; // a read in progress starts over
+        }
+
+        // Extra steps that take up the play when the leadscrew starts turning
+        // in direction dir, 0 if the nut is already loaded that way
+        static inline uint8_t take_up(bool dir) {
+            if (dir == backlash_reverse) {
+                return 0;
+            }
+            backlash_reverse = dir;
+            return backlash;
+        }
+
+        // Once the nut is loaded in reverse the carriage lags the leadscrew by
+        // the play
+        static inline int64_t get_carriage_position() {
+            return get_position() + (backlash_reverse ? backlash : 0);
+        }
+
+        // The carriage position reads 0 from here on, with interrupts off
+        static inline void set_home() {
+            position_base = position_base - get_carriage_position();
+            train_sequence = train_sequence + 1; // a read in progress starts over
+        }
+
+        // Consistent against folds, homing and the step train from any
+        // context below TIM1_UP
+        static inline int64_t get_position() {
+            int64_t p;
+            uint8_t s;
+            do {
+                s = train_sequence;
+                p = position_base + position;
+                if (train_running) {
+                    uint16_t pulses = TIM4->CNT - train_mark;
+                    p += state.direction ? -pulses : pulses;
+                }
+            } while (s != train_sequence);
+            return p;
+        }
+
     private:
+        static void free_running_mode() {
+            TIM3->SMCR &= ~TIM_SMCR_SMS_Msk; // no slave mode, ignore TIM1 TRGO
+            TIM3->CR1 &= ~TIM_CR1_OPM;
+            TIM3->CR1 |= TIM_CR1_ARPE; // auto-reload preload
+            TIM3->CCMR2 &= ~TIM_CCMR2_OC3FE_Msk;
+            TIM3->CCMR2 |= TIM_CCMR2_OC3PE; // compare preload
+        }
+
+        static inline void load(train_entry e) {
+            TIM3->ARR = e.arr;
+            TIM3->CCR3 = e.ccr3;
+        }
+
+        // Loads the preloaded registers with an update event that sets no UIF.
+        // A UIF cleared right after would still leave the update interrupt
+        // pending in the NVIC, counting a pulse that never went out.
+        static inline void load_preloaded() {
+            TIM3->CR1 |= TIM_CR1_URS;
+            TIM3->EGR = TIM_EGR_UG;
+            TIM3->CR1 &= ~TIM_CR1_URS;
+        }
+
+        // Moves the pulses TIM4 counted since the last fold into position
+        static inline void fold_train() {
+            uint16_t count = TIM4->CNT;
+            uint16_t pulses = count - train_mark;
+            train_mark = count;
+            position = position + (state.direction ? -pulses : pulses); // direction is true in reverse
+            train_sequence = train_sequence + 1;
+        }
+
         static void setup_next_pulse() {
             if (state.delayed_pulse) {
                 TIM3->CCMR2 &= ~TIM_CCMR2_OC3FE_Msk; // output compare 3 fast disable
-                TIM3->CCR3 = state.counts_delayed.cnt_start; // load new capture/compare value
-                TIM3->ARR = state.counts_delayed.cnt_stop; //  load the new reload value
+                load_first_pulse(state.counts_delayed.cnt_start, state.counts_delayed.cnt_stop);
             } else {
                 TIM3->CCMR2 |= TIM_CCMR2_OC3FE; // enable fast enable
-                TIM3->CCR3 = 1; // For some reason 0 does not work
-                TIM3->ARR = state.counts_step;
+                load_first_pulse(1, state.counts_step); // For some reason 0 does not work
+            }
+        }
+
+        // Compare and reload of the first pulse of the next trigger, with the
+        // timer stopped
+        static void load_first_pulse(uint16_t ccr3, uint16_t arr) {
+            uint8_t pulses = burst;
+            burst_left = pulses;
+            if (pulses == 1) {
+                if (burst_loaded) {
+                    TIM3->CR1 &= ~TIM_CR1_ARPE;
+                    TIM3->CCMR2 &= ~TIM_CCMR2_OC3PE_Msk;
+                    TIM3->CR1 |= TIM_CR1_OPM;
+                    burst_loaded = false;
+                }
+                TIM3->CCR3 = ccr3; // load new capture/compare value
+                TIM3->ARR = arr; // load the new reload value
+                return;
             }
+            TIM3->CR1 &= ~TIM_CR1_OPM;
+            TIM3->CR1 |= TIM_CR1_ARPE;
+            TIM3->CCMR2 |= TIM_CCMR2_OC3PE;
+            TIM3->CCR3 = ccr3;
+            TIM3->ARR = arr;
+            load_preloaded(); // the counter is stopped, this only loads them
+            set_period(burst_period); // preloaded for the rest of the burst
+            burst_loaded = true;
         }
     };
 
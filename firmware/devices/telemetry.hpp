@@ -0,0 +1,80 @@
+#pragma once
+#include "stm32f103xb.h"
+#include "log_format.hpp"
+
+namespace devices {
+
+    // Per jump records from TIM1_CC_IRQHandler, the only producer, to the main
+    // loop, the only consumer, which passes them on to the log. Each index is
+    // written by one side only, so no locking is needed.
+    struct telemetry {
+        static constexpr uint8_t Forward = 0x1; // a forward jump, otherwise a reversal
+        static constexpr uint8_t Reverse = 0x2; // the leadscrew turns in reverse
+        static constexpr uint8_t Ramping = 0x4; // catching up with the spindle
+        static constexpr uint8_t Ring_size = 32; // power of two
+        static constexpr uint32_t Baud_rate = 1000000; // of the UART while enabled
+
+        volatile static inline uint8_t decimation = 0; // 0 off, otherwise every nth jump is recorded
+        volatile static inline uint32_t overflows = 0; // records lost to a full ring
+
+        // From TIM1_CC_IRQHandler
+        static inline void record(uint16_t count, int32_t error, uint16_t delay, uint16_t period, uint8_t flags) {
+            uint8_t n = decimation;
+            if (n == 0) {
+                return;
+            }
+            uint16_t s = sequence;
+            sequence = s + 1;
+            uint8_t c = skipped + 1;
+            if (c < n) {
+                skipped = c;
+                return;
+            }
+            skipped = 0;
+            uint8_t h = head;
+            if (static_cast<uint8_t>(h - tail) == Ring_size) {
+                overflows = overflows + 1;
+                return;
+            }
+            auto& r = ring[h % Ring_size];
+            r.sequence = s;
+            r.count = count;
+            r.error = error;
+            r.delay = delay;
+            r.period = period;
+            r.flags = flags;
+            head = h + 1; // publish after the record is complete
+        }
+
+        // Main loop, returns false when the ring is empty
+        static bool take(telemetry_record_t& r) {
+            uint8_t t = tail;
+            if (t == head) {
+                return false;
+            }
+            auto& src = ring[t % Ring_size];
+            r.sequence = src.sequence;
+            r.count = src.count;
+            r.error = src.error;
+            r.delay = src.delay;
+            r.period = src.period;
+            r.flags = src.flags;
+            tail = t + 1;
+            return true;
+        }
+
+        // Main loop, with the ISR not recording
+        static void reset() {
+            sequence = 0;
+            skipped = 0;
+            tail = head;
+        }
+
+    private:
+        volatile static inline telemetry_record_t ring[Ring_size];
+        volatile static inline uint8_t head = 0; // next record written, free running
+        volatile static inline uint8_t tail = 0; // next record taken, free running
+        volatile static inline uint16_t sequence = 0;
+        volatile static inline uint8_t skipped = 0;
+    };
+}
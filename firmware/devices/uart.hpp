@@ -6,22 +6,53 @@
 namespace devices {
     constexpr uint64_t BaudRate = 115200;
 
+    // USART1 transmit through a ring buffer drained by DMA1 channel 4, so
+    // writing never waits for the line. Writes are all or nothing and can
+    // come from any priority, the buffer is only touched with interrupts
+    // masked for the few cycles of the copy.
     struct uart {
+        static constexpr uint16_t Buffer_size = 256; // the uint8_t indices wrap with it
 
-        static void write(int ch) {
-            /*Make sure the transmit data register is empty*/
-            while (!(USART1->SR & USART_SR_TXE)) {}
+        volatile static inline uint8_t buffer[Buffer_size];
+        volatile static inline uint8_t head = 0; // next byte written
+        volatile static inline uint8_t tail = 0; // next byte sent
+        volatile static inline uint8_t sending = 0; // bytes handed to the DMA
 
-            /*Write to transmit data register*/
-            USART1->DR = (ch & 0xFF);
+        // Returns false, writing nothing, when the data does not fit
+        static bool write(const uint8_t* data, uint8_t size) {
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            uint8_t h = head;
+            bool fits = static_cast<uint8_t>(tail - h - 1) >= size;
+            if (fits) {
+                for (uint8_t i = 0; i < size; i++) {
+                    buffer[h++] = data[i];
+                }
+                head = h;
+                if (sending == 0) {
+                    start();
+                }
+            }
+            __set_PRIMASK(primask);
+            return fits;
         }
 
-        static void  write(char* data, int size) {
-            int count = size;
-            while (count--) {
-                while (!(USART1->SR & USART_SR_TXE)) {};
-                USART1->DR = *data++;
+        // Switch the baud rate once everything written has been sent, main
+        // loop only. Returns false, changing nothing, while still sending.
+        static bool set_baud_rate(uint32_t rate) {
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            bool idle = sending == 0 && head == tail && (USART1->SR & USART_SR_TC);
+            if (idle) {
+                USART1->BRR = constants::CPU_Clock_Freq_Hz / rate;
             }
+            __set_PRIMASK(primask);
+            return idle;
+        }
+
+        // Bytes that can be written
+        static uint8_t space() {
+            return tail - head - 1;
         }
 
         static void init() {
@@ -35,16 +66,51 @@ namespace devices {
             GPIOB->CRL |= GPIO_CRL_CNF6_1; // Alternate function output Push-pull
             GPIOB->CRL |= GPIO_CRL_MODE6_1; // Output mode, max speed 2MHz
 
-            // Set up rx pin
-            GPIOB->CRL &= ~(GPIO_CRL_CNF7_Msk | GPIO_CRL_MODE7_Msk); // reset
-            GPIOB->CRL |= GPIO_CRL_CNF7_0; // Floating input
+            // The rx pin (PB7) is not used, it is the index input
+
+            // Set up DMA for TX - CMAR and CNDTR are set for each run of the buffer
+            DMA1_Channel4->CCR &= ~(DMA_CCR_EN | DMA_CCR_PINC_Msk | DMA_CCR_MSIZE_Msk | DMA_CCR_PSIZE_Msk | DMA_CCR_CIRC_Msk);
+            DMA1_Channel4->CPAR = (uintptr_t)&USART1->DR; // dest
+            DMA1_Channel4->CCR |= DMA_CCR_MINC; // memory increment mode
+            DMA1_Channel4->CCR |= DMA_CCR_DIR; // from memory to peripheral
+            DMA1_Channel4->CCR |= DMA_CCR_TCIE; // transfer complete interrupt enable
+            NVIC_SetPriority(DMA1_Channel4_IRQn, 3);
+            NVIC_EnableIRQ(DMA1_Channel4_IRQn);
 
             // Configure USART1
             USART1->BRR = constants::CPU_Clock_Freq_Hz / BaudRate; // baud rate register
+            USART1->CR3 |= USART_CR3_DMAT; // DMA enable transmitter
             USART1->CR1 |= USART_CR1_TE; // Transmitter enable
 
             // Enable USART1
             USART1->CR1 |= USART_CR1_UE; // USART enable
         }
+
+        // TX run sent
+        static void DMA1_Channel4_IRQHandler() {
+            uint32_t primask = __get_PRIMASK();
+            __disable_irq();
+            DMA1->IFCR |= DMA_IFCR_CTCIF4;
+            tail = tail + sending;
+            sending = 0;
+            start();
+            __set_PRIMASK(primask);
+        }
+
+    private:
+        // Hand the next contiguous run of the buffer to the DMA, with interrupts masked
+        static void start() {
+            uint8_t h = head;
+            uint8_t t = tail;
+            if (h == t) {
+                return;
+            }
+            uint16_t run = h > t ? h - t : Buffer_size - t;
+            DMA1_Channel4->CCR &= ~DMA_CCR_EN;
+            DMA1_Channel4->CMAR = (uintptr_t)&buffer[t];
+            DMA1_Channel4->CNDTR = run;
+            sending = run; // at most 255, the buffer always keeps a byte free
+            DMA1_Channel4->CCR |= DMA_CCR_EN;
+        }
     };
 }
@@ -2,23 +2,28 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
-#include <cstdio>
 #include <limits>
 #include <optional>
 #include <string_view>
 
 #include "components/gear.hpp"
+#include "components/ramp.hpp"
+#include "components/limit.hpp"
+#include "components/move.hpp"
+#include "components/presets.hpp"
 #include "devices/encoder.hpp"
+#include "devices/events.hpp"
+#include "devices/home.hpp"
 #include "devices/i2c.hpp"
 #include "devices/uart.hpp"
+#include "devices/log.hpp"
+#include "devices/telemetry.hpp"
 #include "devices/step_gen.hpp"
 #include "devices/rpm.hpp"
-
-#define FLAGS_STEPPER_EN 0x80
-#define FLAGS_RPM_EN 0x40
+#include "devices/perf.hpp"
 
 namespace systick_state {
-  volatile uint8_t rpm_sample_prescale_count = 0;
+  volatile uint8_t rpm_update_count = 0;
   inline volatile unsigned int milliseconds = 0;
 }
 
@@ -45,25 +50,96 @@ namespace control {
     stopped,
     in_sync,
     ramping,
+    moving,
+    armed, // waiting for the spindle to reach a thread start
+    braking, // to a stop at a soft limit
   };
 
-  volatile State state = State::in_sync; // TODO: default should be OFF
+  volatile State state = State::stopped;
+  volatile bool ramp_on_engage = false; // decided in the main loop, see app::prepare_engage()
+  volatile bool armed_compare = false; // the thread start compare has been set, see app::arm()
+
+  // Follow the spindle with count as the phase reference, from the main loop
+  // or from the compare interrupt when armed
+  void follow(bool dir, uint16_t count) {
+    using namespace devices;
+    if (ramp_on_engage) {
+      ramp::engage();
+      state = State::ramping;
+    } else {
+      state = State::in_sync;
+    }
+    gear::restart(dir, count);
+    uint8_t take_up = step_gen::take_up(dir);
+    if (take_up != 0 && !ramp_on_engage) { // take up the play at once
+      step_gen::burst = take_up;
+      step_gen::change_direction(dir);
+      encoder::trigger_manual_pulse();
+      step_gen::burst = gear::ratio().burst;
+      return;
+    }
+    step_gen::burst = gear::ratio().burst;
+    step_gen::change_direction(dir);
+    encoder::trigger_restore();
+    if (take_up != 0) {
+      ramp::add_target(take_up); // catching up takes up the play too
+    }
+  }
+
+  // After every pulse while following the spindle or catching up, see
+  // components/limit.hpp. Same priority as the compare interrupt, which
+  // ignores the gear once the state has left in_sync and ramping.
+  inline void check_limits() {
+    using namespace devices;
+    auto& l = limit::state;
+    if (state != State::in_sync && state != State::ramping) {
+      return;
+    }
+    int64_t p = step_gen::position_base + step_gen::position;
+    bool reverse = step_gen::get_direction();
+    int64_t reach = state == State::ramping ? ramp::reach() : 0;
+    if (reverse ? p - reach > l.brake_left : p + reach < l.brake_right) {
+      return;
+    }
+    int64_t distance = reverse ? p - l.left : l.right - p;
+    if (distance > 0) {
+      uint8_t level = l.level;
+      if (state == State::ramping) {
+        level = ramp::state.level;
+      } else if (step_gen::is_running()) {
+        return; // brake once this pulse or burst is over
+      }
+      encoder::trigger_clear(); // the gear triggers no more steps
+      l.hit = reverse ? limit::Left : limit::Right;
+      state = State::braking;
+      ramp::brake(distance, level);
+      return;
+    }
+    encoder::trigger_clear();
+    ramp::abort();
+    if (step_gen::is_running()) {
+      step_gen::stop_free_running(); // drops the rest of a burst
+    }
+    l.hit = reverse ? limit::Left : limit::Right;
+    state = State::stopped;
+  }
 }
 
 extern "C"
 { // interrupt handlers
   void SysTick_Handler() { // Called every 1 ms
+    devices::perf::scope perf{ devices::perf::systick };
     using namespace systick_state;
     ++milliseconds;
 
     using rpm_sampler = devices::rpm_counter<>;
-    auto psc = rpm_sample_prescale_count;
-    if (++psc == rpm_sampler::Sampling_period) {
-      rpm_sampler::process_sample(devices::encoder::get_count());
-      rpm_sample_prescale_count = 0;
-    } else {
-      rpm_sample_prescale_count = psc;
+    rpm_sampler::process_sample(devices::encoder::get_count());
+    auto n = rpm_update_count;
+    if (++n >= devices::i2c::reg_configuration.rpm_update_ms) {
+      rpm_sampler::update();
+      n = 0;
     }
+    rpm_update_count = n;
     if ((milliseconds & 1023) == 0) {
       devices::debug::toggle_led();
     }
@@ -71,6 +147,7 @@ extern "C"
 
   void TIM1_CC_IRQHandler() {
     using namespace devices;
+    perf::scope perf{ perf::tim1_cc };
     auto enc = encoder::get_count();
     bool dir = step_gen::get_direction();
     const bool fwd = encoder::is_cc_fwd_interrupt();
@@ -79,21 +156,62 @@ extern "C"
       // todo: we need to re-initialize when re-enabling
       return;
     }
+    if (control::state == control::State::braking || control::state == control::State::stopped) {
+      return; // a soft limit stopped following, see control::check_limits()
+    }
+    if (control::state == control::State::armed) {
+      if (!control::armed_compare) {
+        return; // a stale gear compare, the thread start is not set yet
+      }
+      uint16_t start = encoder::get_next(); // the spindle reached the thread start
+      control::follow(encoder::get_direction(), start);
+      log::write(log::event::thread_engaged, start);
+      return;
+    }
     using namespace gear;
+    encoder::check_late(enc, fwd);
+    if (!fwd) {
+      encoder::reversed(systick_state::milliseconds);
+    }
+    if (control::state == control::State::ramping) {
+      if (fwd) { // one more step to catch up on
+        encoder::trigger_clear();
+        state.err = range.next.error;
+        range.next_jump(dir, enc);
+        encoder::trigger_restore();
+        ramp::add_target(ratio().burst);
+        encoder::update_channels(range.next.count, range.prev.count);
+        encoder::check_compares(range.next.count, range.prev.count);
+        telemetry::record(enc, state.err, 0, encoder::last_duration(),
+          telemetry::Forward | telemetry::Ramping | (dir ? telemetry::Reverse : 0));
+        return;
+      }
+      // the spindle reversed before the leadscrew caught up, follow it from here
+      ramp::abort();
+      control::state = control::State::in_sync;
+    }
+    uint16_t delay = 0;
     if (fwd) {
       encoder::trigger_clear();
       state.err = range.next.error;
       range.next_jump(dir, enc);
-      step_gen::set_delay(phase_delay(encoder::last_duration(), range.next.error));
+      delay = phase_delay(encoder::last_duration(), range.next.error);
+      step_gen::set_delay(delay);
+      step_gen::burst = ratio().burst;
       encoder::trigger_restore();
     } else { // Change direction, setup delayed pulse and do manual trigger
       dir = !dir;
+      step_gen::burst = ratio().burst + step_gen::take_up(dir); // loaded by change_direction
       step_gen::change_direction(dir);
       encoder::trigger_manual_pulse();
       state.err = range.prev.error;
       range.next_jump(dir, enc);
+      step_gen::burst = ratio().burst;
     }
     encoder::update_channels(range.next.count, range.prev.count);
+    encoder::check_compares(range.next.count, range.prev.count);
+    telemetry::record(enc, state.err, delay, encoder::last_duration(),
+      (fwd ? telemetry::Forward : 0) | (dir ? telemetry::Reverse : 0));
   }
 
   void TIM2_IRQHandler() {
@@ -102,8 +220,45 @@ extern "C"
 
   void TIM3_IRQHandler() {
     using devices::step_gen;
-    step_gen::process_interrupt();
-    gear::state.output_position += step_gen::get_direction() ? 1 : -1;
+    devices::perf::scope perf{ devices::perf::tim3 };
+    auto state = control::state;
+    if (state == control::State::ramping || state == control::State::braking) {
+      step_gen::clear_interrupt();
+      if (!ramp::step()) {
+        control::state = state == control::State::ramping ? control::State::in_sync : control::State::stopped;
+      }
+    } else {
+      step_gen::process_interrupt();
+    }
+    step_gen::position = step_gen::position + (step_gen::get_direction() ? -1 : 1); // direction is true in reverse
+    if (limit::state.enabled) {
+      control::check_limits();
+    }
+  }
+
+  void TIM1_UP_IRQHandler() { // encoder counter wrapped, same priority as TIM3
+    devices::encoder::process_update();
+    devices::step_gen::fold_position();
+  }
+
+  void DMA1_Channel3_IRQHandler() { // step train half sent, same priority as TIM3
+    if (!move::process_interrupt()) {
+      control::state = control::State::stopped;
+    }
+  }
+
+  void DMA1_Channel1_IRQHandler() { // index pulse
+    devices::encoder::process_index();
+  }
+
+  void EXTI15_10_IRQHandler() { // home switch or command
+    using namespace devices;
+    home::process_interrupt(resolution::encoder(i2c::reg_configuration.encoder_resolution));
+    log::write(log::event::home_set, home::angle);
+  }
+
+  void DMA1_Channel4_IRQHandler() { // log sent
+    devices::uart::DMA1_Channel4_IRQHandler();
   }
 
   void DMA1_Channel5_IRQHandler() {
@@ -111,52 +266,305 @@ extern "C"
   }
 
   void I2C2_EV_IRQHandler() {
+    devices::perf::scope perf{ devices::perf::i2c2_ev };
     devices::i2c::I2C2_EV_IRQHandler();
-
   }
 
 } // extern "C"
 
-int main() {
-  using namespace devices;
+namespace app {
+  uint32_t steps = 0; // the installed step ratio
+  uint32_t counts = 1;
+  char mode = 0;
+  uint8_t apply_requests = 0; // handled so far
+  uint8_t generation = 0xFF; // of the registers acted on, differs at start
+  bool telemetry_on = false; // the UART runs at the telemetry baud rate
+  uint32_t overruns = 0; // reported to the host so far
+  uint32_t overrun_ms = 0; // when they were last reported
+  uint8_t homings = 0;
+  constexpr uint32_t Overrun_ms = 100; // a late compare interrupt is reported at most this often
 
-  devices::debug::init();
-  step_gen::init();
-  encoder::init();
-  encoder::update_channels(
-    gear::range.next.count,
-    gear::range.prev.count);
+  void init() {
+    using namespace devices;
 
-  uart::init();
-  i2c::init();
+    devices::debug::init();
+    perf::init();
+    step_gen::init();
+    encoder::init();
+    encoder::trigger_clear(); // stopped until engaged
+    encoder::update_channels(
+      gear::range.next.count,
+      gear::range.prev.count);
 
-  uint8_t num = 0;
-  uint8_t denom = 1;
-  char mode = 0;
+    home::init();
+    events::init();
 
-  while (true) {
-    if (i2c::reg_settings.gear_num != num || i2c::reg_settings.gear_denom != denom) {
-      num = i2c::reg_settings.gear_num;
-      denom = i2c::reg_settings.gear_denom;
-      gear::configure(num, denom, encoder::get_count());
+    uart::init();
+    i2c::init();
+  }
+
+  // Leadscrew speed in steps/s that keeps up with the spindle
+  uint32_t sync_velocity() {
+    auto& r = gear::ratio();
+    uint64_t counts = devices::rpm_counter<>::get_counts_per_second();
+    return counts * r.N * r.burst / r.D;
+  }
+
+  // Spacing of the pulses of a burst, at max_velocity rather than the speed
+  // estimate, which lags while accelerating
+  void pace_bursts() {
+    using namespace devices;
+    if (gear::ratio().burst > 1 || step_gen::backlash != 0) {
+      step_gen::set_burst_velocity(i2c::reg_configuration.max_velocity);
+    }
+  }
 
-      char buffer[16];
-      uart::write(buffer, sprintf(buffer, "gears changed to %d/%d\n", num, denom));
+  // Ramp up to speed first when the spindle turns faster than the stepper can start
+  void prepare_engage() {
+    pace_bursts();
+    uint32_t sync = sync_velocity();
+    control::ramp_on_engage = ramp::level_for(sync) > 1;
+    if (control::ramp_on_engage) {
+      ramp::set_sync_velocity(sync);
     }
+  }
+
+  // Start following the spindle from where it is now, or arm to start at the
+  // configured thread start
+  void engage() {
+    using namespace devices;
+    limit::state.hit = 0;
+    ramp::configure(i2c::reg_configuration.max_velocity, i2c::reg_configuration.max_acceleration);
+    prepare_engage();
+    if (i2c::reg_configuration.thread_starts != 0) {
+      control::armed_compare = false;
+      control::state = control::State::armed;
+      return;
+    }
+    control::follow(encoder::get_direction(), encoder::get_count());
+  }
+
+  // Once the index has been seen, compare on the next count at the thread
+  // start in the direction the spindle turns. The compare interrupt engages.
+  void arm() {
+    using namespace devices;
+    constexpr int64_t Margin = 32; // counts the spindle may turn before the compare is set
+    auto& c = i2c::reg_configuration;
+    int64_t resolution = devices::resolution::encoder(c.encoder_resolution);
+    int64_t phase = encoder::get_index_count() + (c.thread_start % c.thread_starts) * resolution / c.thread_starts;
+    int64_t now = encoder::get_extended_count();
+    bool dir = encoder::get_direction();
+    int64_t ahead = ((dir ? now - phase : phase - now) % resolution + resolution) % resolution;
+    if (ahead < Margin) {
+      ahead += resolution;
+    }
+    uint16_t start = dir ? now - ahead : now + ahead;
+    NVIC_DisableIRQ(TIM1_CC_IRQn);
+    encoder::update_channels(start, start);
+    encoder::clear_cc_interrupt();
+    control::armed_compare = true;
+    NVIC_EnableIRQ(TIM1_CC_IRQn);
+  }
+
+  void disengage() {
+    NVIC_DisableIRQ(TIM1_CC_IRQn);
+    NVIC_DisableIRQ(TIM3_IRQn);
+    control::state = control::State::stopped;
+    ramp::abort();
+    devices::encoder::trigger_clear(); // no hardware triggered steps while stopped
+    NVIC_EnableIRQ(TIM3_IRQn);
+    NVIC_EnableIRQ(TIM1_CC_IRQn);
+    move::abort();
+  }
+
+  // A move written to SETTINGS in mode 2, taken once the previous one has ended
+  void start_move() {
+    using namespace devices;
+    auto& s = i2c::reg_settings; // only changed by i2c::apply() from this loop
+    int32_t target = s.target;
+    bool rapid = s.move == 0x2;
+    s.move = 0;
+    auto& c = i2c::reg_configuration;
+    uint32_t velocity = std::min(rapid ? s.rapid_velocity : s.feed_velocity, c.max_velocity);
+    uint32_t acceleration = std::min(s.acceleration, c.max_acceleration);
+    if (velocity == 0) {
+      return;
+    }
+    limit::state.hit = 0;
+    target = limit::clamp(target); // the move brakes onto the limit
+    control::state = control::State::moving;
+    int64_t position = step_gen::get_position();
+    if (target != position) {
+      step_gen::backlash_reverse = target < position; // moves are in leadscrew steps, the play is not taken up
+    }
+    move::go_to(target, velocity, acceleration);
+    if (!move::state.running) { // already there
+      control::state = control::State::stopped;
+    }
+  }
+
+  // Act on the registers once per apply
+  void registers_applied() {
+    using namespace devices;
+
+    uint32_t s = steps, c = counts;
+    presets::Preset preset{};
+    if (i2c::reg_settings.preset != 0) {
+      preset = presets::get(i2c::reg_settings.preset); // reduced at compile time for fixed hardware
+      s = preset.steps;
+      c = preset.counts;
+    } else {
+      i2c::step_ratio(i2c::reg_configuration, i2c::reg_pitch, s, c); // validated on apply
+    }
+    if (s != steps || c != counts) {
+      steps = s;
+      counts = c;
+      if (preset.valid) {
+        gear::configure(preset.ratio, preset.forward, preset.reverse, encoder::get_count());
+      } else {
+        gear::configure(steps, counts, encoder::get_count());
+      }
+
+      log::write(log::event::gear_changed, i2c::reg_pitch.pitch_num, i2c::reg_pitch.pitch_denom,
+        static_cast<uint16_t>(steps), static_cast<uint16_t>(counts));
+    }
+
+    step_gen::backlash = i2c::reg_motion.backlash;
+    gear::deadband = i2c::reg_motion.deadband;
+    limit::configure(i2c::reg_motion.limits, i2c::reg_motion.left_limit, i2c::reg_motion.right_limit);
 
     if (i2c::reg_settings.mode != mode) {
       mode = i2c::reg_settings.mode;
-      if (mode == 0x1) {
+      disengage();
+      if (mode == 0x1 || mode == 0x2) {
         step_gen::configure(
           i2c::reg_configuration.stepper_change_dwell_ns,
           i2c::reg_configuration.stepper_pulse_length_ns,
           i2c::reg_configuration.stepper_flags & 0x1,
           i2c::reg_configuration.stepper_flags & 0x2);
-        char buffer[16];
-        uart::write(buffer, sprintf(buffer, "set mode to %d\n", mode));
+        if (mode == 0x1) {
+          engage();
+        }
+        log::write(log::event::mode_set, mode);
       }
+    } else if (mode == 0x1 && control::state == control::State::stopped) {
+      engage(); // again after a soft limit stopped the leadscrew
     }
   }
 
+  // Switch the UART over before records flow, and pass them on to the log
+  // as long as they fit
+  void send_telemetry() {
+    using namespace devices;
+    uint8_t decimation = i2c::reg_telemetry.decimation;
+    bool on = decimation != 0;
+    if (on != telemetry_on && uart::set_baud_rate(on ? telemetry::Baud_rate : BaudRate)) {
+      telemetry_on = on;
+      telemetry::decimation = 0;
+      telemetry::reset();
+    }
+    telemetry::decimation = telemetry_on ? decimation : 0;
+    telemetry_record_t r;
+    while (uart::space() >= sizeof(r) + 4 && telemetry::take(r)) {
+      log::write(log::event::telemetry, r);
+    }
+  }
+
+  // Queued for the host, which the interrupt line tells to read EVENT
+  void post(uint8_t type, uint16_t data) {
+    devices::events::push(type, data, systick_state::milliseconds);
+  }
+
+  // Events counted by interrupts
+  void post_counted() {
+    using namespace devices;
+    uint32_t o = encoder::overruns;
+    if (o != overruns && systick_state::milliseconds - overrun_ms >= Overrun_ms) {
+      post(events::Overrun, static_cast<uint16_t>(std::min<uint32_t>(o - overruns, 0xFFFF)));
+      overruns = o;
+      overrun_ms = systick_state::milliseconds;
+    }
+    uint8_t h = home::homings;
+    if (h != homings) {
+      homings = h;
+      post(events::Homed, home::angle);
+    }
+  }
+
+  // One pass of the main loop
+  void poll() {
+    using namespace devices;
+
+    uint8_t requests = i2c::get_apply_requests();
+    if (requests != apply_requests) {
+      apply_requests = requests;
+      if (!i2c::apply()) {
+        log::write(log::event::register_rejected, i2c::reg_info.rejected);
+        post(events::Rejected, i2c::reg_info.rejected);
+      }
+    }
+    if (i2c::reg_info.generation != generation) {
+      generation = i2c::reg_info.generation;
+      registers_applied();
+    }
+
+    if (mode == 0x2 && control::state == control::State::stopped && i2c::reg_settings.move != 0) {
+      start_move();
+    }
+    uint8_t state = static_cast<uint8_t>(control::state);
+    if (state != i2c::reg_state.control) {
+      uint8_t from = i2c::reg_state.control;
+      i2c::reg_state.control = state;
+      log::write(log::event::control_changed, state);
+      if (control::state == control::State::in_sync) {
+        post(events::In_sync, encoder::get_count());
+      } else if (control::state == control::State::stopped) {
+        post(events::Stopped, from);
+      }
+    }
+
+    if (limit::state.enabled) {
+      if (control::state == control::State::in_sync) {
+        limit::plan(sync_velocity());
+      } else if (control::state == control::State::ramping) {
+        limit::at_limits();
+      } else {
+        limit::clear();
+      }
+    }
+    if (limit::state.hit != i2c::reg_state.limit) {
+      i2c::reg_state.limit = limit::state.hit;
+      if (limit::state.hit != 0) {
+        log::write(log::event::limit_reached, limit::state.hit);
+        post(events::Limit, limit::state.hit);
+      }
+    }
+
+    post_counted();
+    send_telemetry();
+
+    encoder::adapt_filter(rpm_counter<>::get_counts_per_second());
+
+    pace_bursts();
+    if (control::state == control::State::ramping) {
+      ramp::set_sync_velocity(sync_velocity());
+    } else if (control::state == control::State::armed) {
+      prepare_engage(); // the spindle may change speed while waiting
+      if (!control::armed_compare && encoder::index_seen) {
+        arm();
+      }
+    }
+  }
+}
+
+#ifndef MELS_SIM
+int main() {
+  app::init();
+
+  while (true) {
+    app::poll();
+  }
+
   return 0;
 }
+#endif
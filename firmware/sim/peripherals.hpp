@@ -0,0 +1,581 @@
+#pragma once
+// Behavioural model of the STM32F103 peripherals used by the firmware.
+//
+// Time is kept in CPU cycles (72 MHz). TIM1 is modelled in encoder mode with
+// its CC3/CC4 compares and OC3REF as TRGO, TIM2 as the period capture timer
+// fed from the OC3 pin, TIM3 as the step pulse generator and TIM4 counting
+// its pulses, USART1 sending from DMA. Only the features the firmware
+// configures are modelled.
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include "stm32f103xb.h"
+
+namespace sim {
+    using cycles = uint64_t;
+
+    constexpr cycles never = std::numeric_limits<cycles>::max();
+    constexpr cycles cpu_hz = 72000000;
+    constexpr cycles apb1_timer_div = 2; // TIM2-4 are clocked at 36 MHz (APB1 / 4 * 2)
+
+    inline cycles now = 0;
+
+    struct probes {
+        std::function<void(bool active, bool pin)> step;
+        std::function<void(bool level)> dir;
+        std::function<void(char ch)> uart;
+    };
+
+    inline probes probe;
+
+    inline uint32_t field(uint32_t value, uint32_t mask, uint32_t pos) {
+        return (value & mask) >> pos;
+    }
+
+    struct dma_model {
+        struct channel_state {
+            uint32_t transferred = 0;
+            uint32_t length = 0;
+        };
+
+        channel_state channels[7];
+
+        void enabled(int ch) {
+            channels[ch - 1] = { 0, DMA1_Channel1[ch - 1].CNDTR };
+        }
+
+        void request(int ch);
+    };
+
+    inline dma_model dma;
+
+    // TIM4 in external clock mode 1, clocked by TIM3 TRGO (ITR2)
+    struct pulse_counter_model {
+        TIM_TypeDef& t = sim::tim4;
+
+        void trgo_edge() {
+            bool clocked = field(t.SMCR, TIM_SMCR_SMS_Msk, TIM_SMCR_SMS_Pos) == 7
+                && field(t.SMCR, TIM_SMCR_TS_Msk, TIM_SMCR_TS_Pos) == 2;
+            if (clocked && (t.CR1 & TIM_CR1_CEN)) {
+                t.CNT = t.CNT >= t.ARR ? 0 : t.CNT + 1;
+            }
+        }
+
+        // Rising edge on CH2 (TI2), the index pulse, captured by IC1 mapped on TI2
+        void capture() {
+            bool input = field(t.CCMR1, TIM_CCMR1_CC1S_Msk, TIM_CCMR1_CC1S_Pos) == 2;
+            if (!input || !(t.CCER & TIM_CCER_CC1E)) {
+                return;
+            }
+            t.CCR1 = t.CNT;
+            t.SR |= TIM_SR_CC1IF;
+            if (t.DIER & TIM_DIER_CC1DE) {
+                dma.request(1);
+            }
+        }
+    };
+
+    inline pulse_counter_model tim4_model;
+
+    // TIM3 channel 3 in PWM mode, one-pulse or free running
+    struct pulse_timer_model {
+        TIM_TypeDef& t = sim::tim3;
+        bool running = false;
+        bool active = false; // OC3REF
+        bool compared = false; // compare already matched in this period
+        cycles origin = 0; // time at which CNT was 0
+        uint32_t reload = 0xFFFF; // active auto-reload value
+        uint32_t ccr3 = 0; // active compare value when preloaded
+        uint32_t burst = 0; // DMA burst transfers done for the current update
+        uint64_t ignored_triggers = 0;
+
+        cycles tick() const {
+            return apb1_timer_div * (t.PSC + 1);
+        }
+
+        uint32_t mode() const {
+            return field(t.CCMR2, TIM_CCMR2_OC3M_Msk, TIM_CCMR2_OC3M_Pos);
+        }
+
+        uint32_t arr() const {
+            return (t.CR1 & TIM_CR1_ARPE) ? reload : t.ARR;
+        }
+
+        uint32_t compare() const {
+            return (t.CCMR2 & TIM_CCMR2_OC3PE) ? ccr3 : t.CCR3;
+        }
+
+        cycles ticks() const {
+            return (now - origin) / tick();
+        }
+
+        uint32_t count() const {
+            return running ? static_cast<uint32_t>(ticks()) : t.CNT;
+        }
+
+        // Output level once the counter has passed the compare value
+        bool matched_level() const {
+            return mode() == 7 || mode() == 5;
+        }
+
+        bool level_at(uint32_t cnt) const {
+            switch (mode()) {
+            case 4: return false;
+            case 5: return true;
+            case 6: return cnt < compare();
+            case 7: return cnt >= compare();
+            default: return active;
+            }
+        }
+
+        void set_output(bool level) {
+            if (level == active) {
+                return;
+            }
+            active = level;
+            if (level && field(t.CR2, TIM_CR2_MMS_Msk, TIM_CR2_MMS_Pos) == 6) {
+                tim4_model.trgo_edge();
+            }
+            if (probe.step) {
+                bool pin = (t.CCER & TIM_CCER_CC3E) && (level != bool(t.CCER & TIM_CCER_CC3P));
+                probe.step(level, pin);
+            }
+        }
+
+        void start(bool fast) {
+            running = true;
+            compared = false;
+            if (!(t.CR1 & TIM_CR1_ARPE)) {
+                reload = t.ARR; // preloaded values are only taken on an update
+            }
+            origin = now - static_cast<cycles>(t.CNT) * tick();
+            set_output(fast && (t.CCMR2 & TIM_CCMR2_OC3FE) ? matched_level() : level_at(t.CNT));
+        }
+
+        void stop() {
+            t.CNT = count();
+            running = false;
+        }
+
+        // Rising edge on TRGI (ITR0 = TIM1 TRGO)
+        void trigger() {
+            bool trigger_mode = field(t.SMCR, TIM_SMCR_SMS_Msk, TIM_SMCR_SMS_Pos) == 6;
+            if (!trigger_mode || field(t.SMCR, TIM_SMCR_TS_Msk, TIM_SMCR_TS_Pos) != 0) {
+                return;
+            }
+            if (t.CR1 & TIM_CR1_CEN) {
+                ++ignored_triggers; // still busy with the previous pulse
+                return;
+            }
+            t.CR1.value |= TIM_CR1_CEN;
+            start(true);
+        }
+
+        cycles compare_time() const {
+            if (!compared && compare() >= ticks() && compare() <= arr()) {
+                return origin + static_cast<cycles>(compare()) * tick();
+            }
+            return never;
+        }
+
+        cycles update_time() const {
+            // counting past a reduced ARR runs on until the counter overflows
+            cycles end = ticks() <= arr() + 1ull ? arr() + 1ull : 0x10000ull;
+            return origin + end * tick();
+        }
+
+        cycles next_event() const {
+            if (!running) {
+                return never;
+            }
+            return std::min(compare_time(), update_time());
+        }
+
+        void process() {
+            if (!running) {
+                return;
+            }
+            if (now == compare_time()) {
+                compared = true;
+                set_output(matched_level());
+            }
+            if (now == update_time()) {
+                update();
+            }
+        }
+
+        void update() {
+            t.SR |= TIM_SR_UIF;
+            reload = t.ARR;
+            ccr3 = t.CCR3;
+            if (t.CR1 & TIM_CR1_OPM) {
+                t.CR1.value &= ~TIM_CR1_CEN;
+                t.CNT = 0;
+                running = false;
+            } else {
+                origin = now;
+            }
+            compared = false;
+            set_output(level_at(0));
+            if (t.DIER & TIM_DIER_UDE) {
+                uint32_t length = field(t.DCR, TIM_DCR_DBL_Msk, TIM_DCR_DBL_Pos) + 1;
+                for (burst = 0; burst < length; burst++) {
+                    dma.request(3);
+                }
+            }
+        }
+
+        // DMAR: each transfer of a burst goes to the next register from DBA
+        void burst_written(uint32_t value) {
+            uint32_t index = field(t.DCR, TIM_DCR_DBA_Msk, TIM_DCR_DBA_Pos) + burst;
+            reinterpret_cast<volatile uint32_t*>(&t)[index] = value;
+        }
+
+        void control_written(uint32_t previous, uint32_t value) {
+            if (!(previous & TIM_CR1_CEN) && (value & TIM_CR1_CEN)) {
+                start(false);
+            } else if ((previous & TIM_CR1_CEN) && !(value & TIM_CR1_CEN)) {
+                stop();
+            }
+        }
+
+        void mode_written() {
+            if (mode() == 4 || mode() == 5) {
+                set_output(mode() == 5);
+            }
+        }
+
+        // EGR.UG: reload the shadow registers and restart the period
+        void event_generated(uint32_t value) {
+            if (!(value & TIM_EGR_UG)) {
+                return;
+            }
+            reload = t.ARR;
+            ccr3 = t.CCR3;
+            t.CNT = 0;
+            if (running) {
+                origin = now;
+                compared = false;
+            }
+            if (!(t.CR1 & TIM_CR1_URS)) {
+                t.SR |= TIM_SR_UIF;
+            }
+            t.EGR.value = 0;
+        }
+    };
+
+    inline pulse_timer_model tim3_model;
+
+    // TIM2 counting on the internal clock, reset and captured by TI2
+    struct capture_timer_model {
+        TIM_TypeDef& t = sim::tim2;
+        cycles origin = 0;
+        bool ti2 = false;
+
+        cycles tick() const {
+            return apb1_timer_div * (t.PSC + 1);
+        }
+
+        cycles ticks() const {
+            return (now - origin) / tick();
+        }
+
+        uint32_t count() const {
+            if (!(t.CR1 & TIM_CR1_CEN)) {
+                return t.CNT;
+            }
+            return static_cast<uint32_t>(ticks() % (t.ARR + 1ull));
+        }
+
+        void ti2_edge(bool level) {
+            if (level == ti2) {
+                return;
+            }
+            ti2 = level;
+            if (!(t.CR1 & TIM_CR1_CEN)) {
+                return;
+            }
+            bool falling = !level;
+            uint32_t cnt = count();
+            if (field(t.CCMR1, TIM_CCMR1_CC1S_Msk, TIM_CCMR1_CC1S_Pos) == 2 && (t.CCER & TIM_CCER_CC1E)
+                && falling == bool(t.CCER & TIM_CCER_CC1P)) {
+                t.CCR1 = cnt;
+                t.SR |= TIM_SR_CC1IF;
+                if (t.DIER & TIM_DIER_CC1DE) {
+                    dma.request(5);
+                }
+            }
+            if (field(t.CCMR1, TIM_CCMR1_CC2S_Msk, TIM_CCMR1_CC2S_Pos) == 1 && (t.CCER & TIM_CCER_CC2E)
+                && falling == bool(t.CCER & TIM_CCER_CC2P)) {
+                t.CCR2 = cnt;
+                t.SR |= TIM_SR_CC2IF;
+                if (t.DIER & TIM_DIER_CC2DE) {
+                    dma.request(7);
+                }
+            }
+            bool reset_mode = field(t.SMCR, TIM_SMCR_SMS_Msk, TIM_SMCR_SMS_Pos) == 4;
+            bool on_ti2fp2 = field(t.SMCR, TIM_SMCR_TS_Msk, TIM_SMCR_TS_Pos) == 6;
+            if (reset_mode && on_ti2fp2 && falling == bool(t.CCER & TIM_CCER_CC2P)) {
+                origin = now;
+                t.SR |= TIM_SR_UIF;
+            }
+        }
+
+        cycles next_event() const {
+            if (!(t.CR1 & TIM_CR1_CEN) || !(t.DIER & TIM_DIER_CC3IE)) {
+                return never;
+            }
+            cycles period = t.ARR + 1ull;
+            cycles cnt = count();
+            cycles delta = t.CCR3 > cnt ? t.CCR3 - cnt : t.CCR3 + period - cnt;
+            return origin + (ticks() + delta) * tick();
+        }
+
+        void process() {
+            if (count() == t.CCR3 && now == origin + ticks() * tick()) {
+                t.SR |= TIM_SR_CC3IF;
+            }
+        }
+
+        void control_written(uint32_t previous, uint32_t value) {
+            if (!(previous & TIM_CR1_CEN) && (value & TIM_CR1_CEN)) {
+                origin = now - static_cast<cycles>(t.CNT) * tick();
+            } else if ((previous & TIM_CR1_CEN) && !(value & TIM_CR1_CEN)) {
+                t.CNT = count();
+            }
+        }
+    };
+
+    inline capture_timer_model tim2_model;
+
+    // TIM1 in encoder mode, compares on CC3/CC4 and OC3REF driving TRGO and the OC3 pin
+    struct encoder_timer_model {
+        TIM_TypeDef& t = sim::tim1;
+        bool oc3ref = false;
+        uint64_t overruns = 0; // compare matched again before the flag was cleared
+
+        uint32_t mode() const {
+            return field(t.CCMR2, TIM_CCMR2_OC3M_Msk, TIM_CCMR2_OC3M_Pos);
+        }
+
+        // Shortest input pulse that passes the IC1 filter, N samples at the
+        // sampling frequency selected by IC1F, from CK_INT or DTS
+        cycles filter_window() const {
+            static constexpr uint8_t divider[] = { 1, 1, 1, 1, 2, 2, 4, 4, 8, 8, 16, 16, 16, 32, 32, 32 };
+            static constexpr uint8_t samples[] = { 1, 2, 4, 8, 6, 8, 6, 8, 6, 8, 5, 6, 8, 5, 6, 8 };
+            uint32_t f = field(t.CCMR1, TIM_CCMR1_IC1F_Msk, TIM_CCMR1_IC1F_Pos);
+            uint32_t dts = f >= 4 ? 1u << field(t.CR1, TIM_CR1_CKD_Msk, TIM_CR1_CKD_Pos) : 1;
+            return f == 0 ? 0 : cycles(samples[f]) * divider[f] * dts;
+        }
+
+        void set_oc3ref(bool level) {
+            if (level == oc3ref) {
+                return;
+            }
+            oc3ref = level;
+            if (level && field(t.CR2, TIM_CR2_MMS_Msk, TIM_CR2_MMS_Pos) == 6) {
+                tim3_model.trigger();
+            }
+            if ((t.CCER & TIM_CCER_CC3E) && (t.BDTR & TIM_BDTR_MOE)) {
+                // OC3 (PA10) is wired to TIM2 CH2
+                tim2_model.ti2_edge(level != bool(t.CCER & TIM_CCER_CC3P));
+            }
+        }
+
+        void match(uint32_t flag) {
+            if (t.SR & flag) {
+                ++overruns;
+            }
+            t.SR |= flag;
+        }
+
+        void count(int direction) {
+            uint32_t sms = field(t.SMCR, TIM_SMCR_SMS_Msk, TIM_SMCR_SMS_Pos);
+            if (!(t.CR1 & TIM_CR1_CEN) || sms == 0 || sms > 3) {
+                return;
+            }
+            uint32_t cnt = t.CNT;
+            if (direction > 0) {
+                t.CR1.value &= ~TIM_CR1_DIR;
+                cnt = cnt >= t.ARR ? 0 : cnt + 1;
+            } else {
+                t.CR1.value |= TIM_CR1_DIR;
+                cnt = cnt == 0 ? t.ARR : cnt - 1;
+            }
+            t.CNT = cnt;
+            if ((direction > 0 && cnt == 0) || (direction < 0 && cnt == t.ARR)) {
+                t.SR |= TIM_SR_UIF;
+            }
+            if (cnt == t.CCR3) {
+                match(TIM_SR_CC3IF);
+                switch (mode()) {
+                case 1: set_oc3ref(true); break;
+                case 2: set_oc3ref(false); break;
+                case 3: set_oc3ref(!oc3ref); break;
+                }
+            }
+            if (cnt == t.CCR4) {
+                match(TIM_SR_CC4IF);
+            }
+        }
+
+        void mode_written() {
+            if (mode() == 4 || mode() == 5) {
+                set_oc3ref(mode() == 5);
+            }
+        }
+    };
+
+    inline encoder_timer_model tim1_model;
+
+    // USART1 transmitting from DMA channel 4, a byte per frame time (8N1)
+    struct serial_model {
+        cycles next = never;
+
+        bool active() const {
+            auto& c = *DMA1_Channel4;
+            return (USART1->CR3 & USART_CR3_DMAT) && (c.CCR & DMA_CCR_EN) && c.CNDTR != 0;
+        }
+
+        cycles next_event() {
+            if (!active()) {
+                next = never;
+            } else if (next == never) {
+                next = now + 10 * USART1->BRR;
+            }
+            return next;
+        }
+
+        void process() {
+            dma.request(4);
+            next = now + 10 * USART1->BRR;
+        }
+    };
+
+    inline serial_model usart1_model;
+
+    inline void write_peripheral(uintptr_t address, uint32_t value, uint32_t size) {
+        if (address == reinterpret_cast<uintptr_t>(&USART1->DR)) {
+            USART1->DR = value;
+            return;
+        }
+        if (address == reinterpret_cast<uintptr_t>(&TIM3->DMAR)) {
+            tim3_model.burst_written(value);
+            return;
+        }
+        std::memcpy(reinterpret_cast<void*>(address), &value, size);
+    }
+
+    inline void dma_model::request(int ch) {
+        auto& c = DMA1_Channel1[ch - 1];
+        auto& s = channels[ch - 1];
+        if (!(c.CCR & DMA_CCR_EN) || c.CNDTR == 0) {
+            return;
+        }
+        uint32_t psize = 1u << field(c.CCR, DMA_CCR_PSIZE_Msk, DMA_CCR_PSIZE_Pos);
+        uint32_t msize = 1u << field(c.CCR, DMA_CCR_MSIZE_Msk, DMA_CCR_MSIZE_Pos);
+        uintptr_t peripheral = c.CPAR + ((c.CCR & DMA_CCR_PINC) ? s.transferred * psize : 0);
+        uintptr_t memory = c.CMAR + ((c.CCR & DMA_CCR_MINC) ? s.transferred * msize : 0);
+        uint32_t value = 0;
+        if (c.CCR & DMA_CCR_DIR) {
+            std::memcpy(&value, reinterpret_cast<const void*>(memory), msize);
+            write_peripheral(peripheral, value, psize);
+        } else {
+            std::memcpy(&value, reinterpret_cast<const void*>(peripheral), psize);
+            std::memcpy(reinterpret_cast<void*>(memory), &value, msize);
+        }
+        ++s.transferred;
+        uint32_t flags = 0;
+        if (--c.CNDTR == s.length / 2) {
+            flags |= DMA_ISR_HTIF1;
+        }
+        if (c.CNDTR == 0) {
+            flags |= DMA_ISR_TCIF1;
+            if (c.CCR & DMA_CCR_CIRC) {
+                c.CNDTR = s.length;
+                s.transferred = 0;
+            }
+        }
+        if (flags) {
+            DMA1->ISR |= (flags | DMA_ISR_GIF1) << (4 * (ch - 1));
+        }
+    }
+
+    // A falling edge on the inputs of the given EXTI lines
+    inline void exti_falling(uint32_t lines) {
+        EXTI->PR.value |= lines & EXTI->FTSR;
+    }
+
+    // DWT->CYCCNT. Handlers run instantly in the simulation, so while one is
+    // dispatched the first read gives its start and later reads its end.
+    inline cycles handler_end = never;
+    inline bool handler_started = false;
+
+    inline uint32_t cycle_count() {
+        if (handler_end == never) {
+            return static_cast<uint32_t>(now);
+        }
+        if (!handler_started) {
+            handler_started = true;
+            return static_cast<uint32_t>(now);
+        }
+        return static_cast<uint32_t>(handler_end);
+    }
+
+    // Set by the simulation to latch interrupt lines into the NVIC, so a flag
+    // raised by a register write and cleared again right after still leaves
+    // its interrupt pending as on the real chip
+    inline void (*sample_interrupts)() = nullptr;
+
+    inline void register_written(const volatile void* reg, uint32_t previous, uint32_t value) {
+        if (reg == &TIM1->CCMR2) {
+            tim1_model.mode_written();
+        } else if (reg == &TIM3->CCMR2) {
+            tim3_model.mode_written();
+        } else if (reg == &TIM3->EGR) {
+            tim3_model.event_generated(value);
+        } else if (reg == &TIM3->CR1) {
+            tim3_model.control_written(previous, value);
+        } else if (reg == &TIM2->CR1) {
+            tim2_model.control_written(previous, value);
+        } else if (reg == &GPIOB->BSRR || reg == &GPIOB->BRR) {
+            uint32_t set = reg == &GPIOB->BSRR ? value & 0xFFFF : 0;
+            uint32_t reset = reg == &GPIOB->BSRR ? value >> 16 : value & 0xFFFF;
+            GPIOB->ODR = (GPIOB->ODR & ~reset) | set;
+            GPIOB->BSRR.value = GPIOB->BRR.value = 0;
+        } else if (reg == &GPIOB->ODR) {
+            if (((previous ^ value) & GPIO_ODR_ODR1) && probe.dir) {
+                probe.dir(value & GPIO_ODR_ODR1);
+            }
+        } else if (reg == &DMA1->IFCR) {
+            DMA1->ISR &= ~value;
+            for (int ch = 0; ch < 7; ch++) { // GIF follows the channel's other flags
+                uint32_t flags = (DMA_ISR_TCIF1 | DMA_ISR_HTIF1 | DMA_ISR_TEIF1) << (4 * ch);
+                if (!(DMA1->ISR & flags)) {
+                    DMA1->ISR &= ~(DMA_ISR_GIF1 << (4 * ch));
+                }
+            }
+            DMA1->IFCR.value = 0;
+        } else if (reg == &EXTI->SWIER) {
+            EXTI->PR.value |= value & ~previous & EXTI->IMR; // pending like an edge on the line
+        } else if (reg == &EXTI->PR) {
+            EXTI->PR.value = previous & ~value; // cleared by writing 1
+            EXTI->SWIER.value &= ~value;
+        } else if (reg == &USART1->DR) {
+            if ((USART1->CR1 & USART_CR1_UE) && (USART1->CR1 & USART_CR1_TE) && probe.uart) {
+                probe.uart(static_cast<char>(value));
+            }
+        } else {
+            for (int ch = 1; ch <= 7; ch++) {
+                if (reg == &DMA1_Channel1[ch - 1].CCR && !(previous & DMA_CCR_EN) && (value & DMA_CCR_EN)) {
+                    dma.enabled(ch);
+                }
+            }
+        }
+        if (sample_interrupts) {
+            sample_interrupts();
+        }
+    }
+}
@@ -0,0 +1,856 @@
+// Host build of the firmware against the simulated peripherals.
+//
+// The firmware is compiled in the same translation unit (as on target) and
+// driven by a virtual spindle. Interrupts are dispatched one at a time in
+// priority order after a fixed entry latency and occupy the CPU for an
+// assumed number of cycles, so late service shows up as timing error, missed
+// compares and ignored step triggers.
+//
+// Usage: m-els-sim [options]
+//   --encoder N          encoder transitions per revolution (2400)
+//   --stepper N          stepper pulses per leadscrew revolution (2000)
+//   --gear NUM/DENOM     pitch written to PITCH, mm per spindle revolution (1/1)
+//   --leadscrew NUM/DENOM  leadscrew pitch, mm per revolution (2/1)
+//   --preset N           pitch preset selected in SETTINGS instead of --gear
+//   --profile T:RPM,...  piecewise linear spindle speed, seconds:rpm (0:300,1:300)
+//   --latency CYCLES     interrupt entry latency (12)
+//   --isr NAME=CYCLES    assumed handler cost, NAME is TIM1_CC, TIM1_UP, TIM2, TIM3 or SysTick
+//   --change T:NUM/DENOM,...  write a new pitch to PITCH at the given times
+//   --engage T           start in mode 0 and switch to synchronized motion at T
+//   --thread STARTS/START  thread start the engagement waits for after the index
+//   --timeline FILE      write the step/dir edge timeline as CSV ("-" for stdout)
+//   --telemetry FILE     enable telemetry for every jump and write the records as CSV
+//   --chatter HZ:US      one count forward and back, HZ times a second for US each
+//   --backlash STEPS     play between leadscrew and carriage, written to MOTION (0)
+//   --deadband COUNTS    reversal deadband written to MOTION (0)
+//   --left-limit N       soft limit below which the leadscrew must not go, in steps
+//   --right-limit N      soft limit above which the leadscrew must not go, in steps
+//   --home T             home at T, the carriage position becomes 0
+//   --home-switch T      wait for the home switch instead, it closes at T
+//   --events US          a host reading EVENT US microseconds after the interrupt line goes low
+//
+// Expectations, checked after the run; the exit status is 1 if one fails:
+//   --max-error STEPS    largest position error
+//   --max-timing US      largest timing error
+//   --max-latency CYCLES largest interrupt entry latency of any handler
+//   --max-faults N       dropped step triggers and compare overruns
+//   --position N         final leadscrew position in steps
+
+#include "../main.cpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "peripherals.hpp"
+#include "spindle.hpp"
+#include "../tools/log_decoder.hpp"
+
+namespace sim {
+
+    struct interrupt {
+        const char* name;
+        IRQn_Type irq;
+        void (*handler)();
+        cycles cost;
+        cycles pending_since = never;
+        uint64_t calls = 0;
+        cycles max_latency = 0;
+    };
+
+    bool systick_pending = false;
+
+    std::vector<interrupt> interrupts = {
+        { "SysTick", SysTick_IRQn, SysTick_Handler, 80 },
+        { "TIM1_CC", TIM1_CC_IRQn, TIM1_CC_IRQHandler, 180 },
+        { "TIM1_UP", TIM1_UP_IRQn, TIM1_UP_IRQHandler, 50 },
+        { "TIM2", TIM2_IRQn, TIM2_IRQHandler, 40 },
+        { "TIM3", TIM3_IRQn, TIM3_IRQHandler, 60 },
+        { "DMA1_Channel1", DMA1_Channel1_IRQn, DMA1_Channel1_IRQHandler, 60 },
+        { "DMA1_Channel3", DMA1_Channel3_IRQn, DMA1_Channel3_IRQHandler, 600 },
+        { "DMA1_Channel4", DMA1_Channel4_IRQn, DMA1_Channel4_IRQHandler, 60 },
+        { "DMA1_Channel5", DMA1_Channel5_IRQn, DMA1_Channel5_IRQHandler, 100 },
+        { "I2C2_EV", I2C2_EV_IRQn, I2C2_EV_IRQHandler, 100 },
+        { "EXTI15_10", EXTI15_10_IRQn, EXTI15_10_IRQHandler, 150 },
+    };
+
+    bool flagged(IRQn_Type irq) {
+        auto timer = [](TIM_TypeDef* t) { return (t->SR & t->DIER & 0x7F) != 0; };
+        switch (irq) {
+        case SysTick_IRQn: return systick_pending;
+        case TIM1_UP_IRQn: return (TIM1->SR & TIM1->DIER & TIM_SR_UIF) != 0;
+        case TIM1_CC_IRQn: return (TIM1->SR & TIM1->DIER & (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)) != 0;
+        case TIM2_IRQn: return timer(TIM2);
+        case TIM3_IRQn: return timer(TIM3);
+        case DMA1_Channel1_IRQn: return (DMA1->ISR & DMA_ISR_TCIF1) && (DMA1_Channel1->CCR & DMA_CCR_TCIE);
+        case DMA1_Channel3_IRQn: return ((DMA1->ISR & DMA_ISR_TCIF3) && (DMA1_Channel3->CCR & DMA_CCR_TCIE))
+            || ((DMA1->ISR & DMA_ISR_HTIF3) && (DMA1_Channel3->CCR & DMA_CCR_HTIE));
+        case DMA1_Channel4_IRQn: return (DMA1->ISR & DMA_ISR_TCIF4) && (DMA1_Channel4->CCR & DMA_CCR_TCIE);
+        case DMA1_Channel5_IRQn: return (DMA1->ISR & DMA_ISR_TCIF5) && (DMA1_Channel5->CCR & DMA_CCR_TCIE);
+        case EXTI15_10_IRQn: return (EXTI->PR & EXTI->IMR & 0xFC00) != 0;
+        default: return false;
+        }
+    }
+
+    bool enabled(IRQn_Type irq) {
+        return irq < 0 || nvic.enabled[irq];
+    }
+
+    uint8_t priority(IRQn_Type irq) {
+        return irq < 0 ? 15 : nvic.priority[irq];
+    }
+
+    struct settings {
+        uint16_t encoder = 2400;
+        uint16_t stepper = 2000;
+        uint32_t num = 1;
+        uint32_t denom = 1;
+        uint32_t leadscrew_num = 2;
+        uint32_t leadscrew_denom = 1;
+        uint8_t preset = 0;
+        std::vector<spindle::point> profile = { { 0, 300 }, { 1, 300 } };
+        cycles latency = 12;
+        FILE* timeline = nullptr;
+        FILE* telemetry = nullptr;
+
+        struct change {
+            double time;
+            uint32_t num, denom; // 0 keeps the gear
+            char mode;
+            int32_t target = 0; // move in mode 2
+            uint8_t move = 0; // 1 at feed, 2 at rapid velocity
+        };
+        std::vector<change> changes;
+        double engage = 0;
+        uint8_t thread_starts = 0, thread_start = 0;
+        double chatter_hz = 0;
+        double chatter_us = 0;
+        uint8_t backlash = 0;
+        uint16_t deadband = 0;
+        uint8_t limits = 0;
+        int32_t left_limit = 0;
+        int32_t right_limit = 0;
+        double home = NAN;
+        bool home_switch = false;
+        double events_us = -1; // no host reading events
+
+        // expectations, NAN or -1 when not checked
+        double max_error = NAN;
+        double max_timing = NAN; // us
+        long long max_latency = -1;
+        long long max_faults = -1;
+        bool check_position = false;
+        long long position = 0;
+    };
+
+    struct statistics {
+        uint64_t steps = 0;
+        long long position = 0; // steps, positive when following a forward spindle
+        long long carriage = 0; // position less the play, the nut starts loaded forward
+        int play = 0; // steps the leadscrew has turned back into the play, 0 to backlash
+        double max_error = 0; // steps
+        double sum_error2 = 0;
+        double max_timing = 0; // s
+        double sum_timing2 = 0;
+        uint64_t timed = 0;
+        cycles last_dir_change = never;
+        cycles min_setup = never;
+        cycles step_rise = 0;
+        cycles min_interval = never;
+        cycles min_width = never;
+        double first_fault_rpm = NAN;
+        uint64_t chatter_passed = 0; // glitches longer than the input filter
+        uint64_t chatter_rejected = 0;
+        uint64_t faults = 0;
+        uint64_t telemetry_records = 0;
+        long long home_carriage = 0; // carriage and spindle when homed
+        long long home_count = 0;
+        uint64_t events = 0; // read by the host
+    };
+
+    settings config;
+    statistics stats;
+    cycles busy_until = 0;
+
+    double seconds(cycles c) {
+        return static_cast<double>(c) / cpu_hz;
+    }
+
+    cycles to_cycles(double s) {
+        return static_cast<cycles>(std::ceil(s * cpu_hz));
+    }
+
+    void fault(spindle& s) {
+        if (stats.faults++ == 0) {
+            stats.first_fault_rpm = s.speed(seconds(now)) * 60.0 / s.resolution;
+        }
+    }
+
+    void write_edge(const char* signal, int level, double ideal) {
+        if (config.timeline) {
+            fprintf(config.timeline, "%.1f,%s,%d,%u,%lld,%.3f\n", seconds(now) * 1e9, signal, level,
+                static_cast<unsigned>(TIM1->CNT), stats.position, ideal);
+        }
+    }
+
+    // The ideal position follows the active ratio and is kept continuous when
+    // the firmware switches to another one
+    struct {
+        uint8_t active;
+        int D = 0, N = 0;
+        double offset = 0;
+    } ideal_ratio;
+
+    // The firmware follows the spindle with a deadband wide hysteresis
+    double followed = 0;
+
+    double ideal_position(spindle& s) {
+        double x = s.position(seconds(now));
+        followed = std::clamp(followed, x, x + config.deadband);
+        return followed * ideal_ratio.N / ideal_ratio.D + ideal_ratio.offset;
+    }
+
+    const char* event_name(uint8_t type) {
+        using devices::events;
+        switch (type) {
+        case events::Overflow: return "overflow";
+        case events::Limit: return "limit";
+        case events::In_sync: return "in sync";
+        case events::Stopped: return "stopped";
+        case events::Overrun: return "overrun";
+        case events::Rejected: return "rejected";
+        case events::Homed: return "homed";
+        }
+        return "?";
+    }
+
+    // The host's read of EVENT when the interrupt line is low
+    void read_event() {
+        auto& r = devices::i2c::reg_event;
+        devices::events::pop(r);
+        stats.events++;
+        fprintf(stderr, "[%10.6f] host read event %s, data %u, at %u ms, %u pending\n", seconds(now),
+            event_name(r.type), static_cast<unsigned>(r.data), static_cast<unsigned>(r.time_ms),
+            static_cast<unsigned>(r.pending));
+    }
+
+    control::State last_control = control::State::stopped;
+
+    const char* control_name(control::State state) {
+        switch (state) {
+        case control::State::stopped: return "stopped";
+        case control::State::in_sync: return "in sync";
+        case control::State::ramping: return "ramping";
+        case control::State::moving: return "moving";
+        case control::State::armed: return "armed";
+        case control::State::braking: return "braking";
+        }
+        return "?";
+    }
+
+    // Engaging makes the current positions the phase reference
+    void track_control(spindle& s) {
+        if (control::state == last_control) {
+            return;
+        }
+        fprintf(stderr, "[%10.6f] %s at %.1f rpm, spindle at %lld, leadscrew at %lld\n", seconds(now),
+            control_name(control::state), s.speed(seconds(now)) * 60.0 / s.resolution, s.count,
+            static_cast<long long>(devices::step_gen::get_position()));
+        bool following = last_control == control::State::in_sync || last_control == control::State::ramping;
+        if (!following && control::state != control::State::moving) {
+            ideal_ratio.offset = 0;
+            ideal_ratio.offset = stats.carriage - ideal_position(s);
+        }
+        last_control = control::state;
+    }
+
+    void track_ratio(spindle& s) {
+        auto& r = gear::ratio();
+        if (ideal_ratio.D == 0) {
+            ideal_ratio = { gear::state.active, r.D, r.N * r.burst, 0 };
+        } else if (ideal_ratio.active != gear::state.active) {
+            double before = ideal_position(s);
+            ideal_ratio = { gear::state.active, r.D, r.N * r.burst, 0 };
+            ideal_ratio.offset = before - ideal_position(s);
+        }
+    }
+
+    // Register writes take the same path as from the I2C master
+    template <typename T>
+    void write_register(uint8_t offset, T value) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        devices::i2c::write(offset, bytes, sizeof(T));
+    }
+
+    template <typename T>
+    void write_setting(size_t field, T value) {
+        write_register(devices::i2c::Settings_offset + field, value);
+    }
+
+    template <typename T>
+    void write_configuration(size_t field, T value) {
+        write_register(devices::i2c::Configuration_offset + field, value);
+    }
+
+    template <typename T>
+    void write_pitch(size_t field, T value) {
+        write_register(devices::i2c::Pitch_offset + field, value);
+    }
+
+    void apply_registers() {
+        write_register(devices::i2c::Apply_offset, uint8_t{ 1 });
+    }
+
+    uint8_t config_flags() {
+        return devices::i2c::reg_configuration.stepper_flags;
+    }
+
+    void on_step(bool active, spindle& s) {
+        double ideal = ideal_position(s);
+        if (active) {
+            bool reverse = bool(GPIOB->ODR & GPIO_ODR_ODR1) != bool(config_flags() & 0x2);
+            int sign = reverse ? -1 : 1;
+            stats.position += sign;
+            int play = std::clamp(stats.play - sign, 0, static_cast<int>(config.backlash));
+            bool taking_up = play != stats.play;
+            stats.play = play;
+            if (!taking_up) {
+                stats.carriage += sign;
+            }
+            if (stats.steps++) {
+                stats.min_interval = std::min(stats.min_interval, now - stats.step_rise);
+            }
+            stats.step_rise = now;
+            if (stats.last_dir_change != never) {
+                stats.min_setup = std::min(stats.min_setup, now - stats.last_dir_change);
+            }
+
+            if (control::state != control::State::in_sync || taking_up) {
+                write_edge("step", active, ideal); // catching up or taking up the play, no error yet
+                return;
+            }
+
+            // The firmware rounds to the nearest step, so step p is due when
+            // the ideal position passes p - 1/2 in the direction of travel
+            double error = ideal - (stats.carriage - 0.5 * sign);
+            stats.max_error = std::max(stats.max_error, std::fabs(error));
+            stats.sum_error2 += error * error;
+            double rate = s.speed(seconds(now)) * ideal_ratio.N / ideal_ratio.D;
+            if (std::fabs(rate) > 1e-9) {
+                double timing = error / std::fabs(rate);
+                stats.max_timing = std::max(stats.max_timing, std::fabs(timing));
+                stats.sum_timing2 += timing * timing;
+                stats.timed++;
+            }
+            if (std::fabs(error) > 1.0) {
+                fault(s);
+            }
+        } else {
+            stats.min_width = std::min(stats.min_width, now - stats.step_rise);
+        }
+        write_edge("step", active, ideal);
+    }
+
+    // The pending bit of an interrupt in the NVIC, SysTick's in the SCB
+    bool& pending(const interrupt& i) {
+        return i.irq < 0 ? systick_pending : nvic.pending[i.irq];
+    }
+
+    // Entering the handler clears the pending bit, a line still or again
+    // asserted while it runs sets it again
+    void dispatch(interrupt& i) {
+        i.max_latency = std::max(i.max_latency, now - i.pending_since);
+        i.calls++;
+        pending(i) = false;
+        i.pending_since = never;
+        handler_end = now + i.cost;
+        handler_started = false;
+        i.handler();
+        handler_end = never;
+        busy_until = now + i.cost;
+    }
+
+    // Earliest time a pending interrupt can be taken
+    cycles next_dispatch() {
+        cycles ready = never;
+        for (auto& i : interrupts) {
+            if (i.pending_since != never && enabled(i.irq)) {
+                ready = std::min(ready, i.pending_since + config.latency);
+            }
+        }
+        return ready == never ? never : std::max(ready, busy_until);
+    }
+
+    // Highest priority interrupt that has become ready
+    interrupt& select() {
+        interrupt* next = nullptr;
+        for (auto& i : interrupts) {
+            if (i.pending_since == never || !enabled(i.irq) || i.pending_since + config.latency > now) {
+                continue;
+            }
+            if (!next || priority(i.irq) < priority(next->irq)
+                || (priority(i.irq) == priority(next->irq) && i.pending_since < next->pending_since)) {
+                next = &i;
+            }
+        }
+        return *next;
+    }
+
+    // Latches asserted lines, and forgets interrupts cleared with
+    // NVIC_ClearPendingIRQ()
+    void update_pending() {
+        for (auto& i : interrupts) {
+            if (flagged(i.irq)) {
+                pending(i) = true;
+            }
+            if (!pending(i)) {
+                i.pending_since = never;
+            } else if (i.pending_since == never) {
+                i.pending_since = now;
+            }
+        }
+    }
+
+    void run(spindle& s) {
+        sample_interrupts = update_pending;
+        const cycles end = to_cycles(s.end_time());
+        const cycles systick_period = cpu_hz / 1000;
+        cycles next_systick = systick_period;
+        int direction = 0;
+        cycles next_edge = to_cycles(s.next_edge(0, direction));
+        size_t change = 0;
+        auto next_change = [&change]() {
+            return change < config.changes.size() ? to_cycles(config.changes[change].time) : never;
+        };
+        const cycles chatter_period = config.chatter_hz > 0 ? to_cycles(1 / config.chatter_hz) : never;
+        const cycles chatter_width = to_cycles(config.chatter_us * 1e-6);
+        cycles next_chatter = chatter_period;
+        cycles chatter_end = never;
+        cycles home_at = std::isnan(config.home) ? never : to_cycles(config.home);
+        cycles host_read = never;
+        auto chatter = [&s](int direction) {
+            uint64_t overruns = tim1_model.overruns;
+            tim1_model.count(direction);
+            if (tim1_model.overruns != overruns) {
+                fault(s);
+            }
+        };
+
+        while (true) {
+            cycles t_irq = next_dispatch();
+            cycles t_tim3 = tim3_model.next_event();
+            cycles t_tim2 = tim2_model.next_event();
+            cycles t_change = next_change();
+            cycles t_usart = usart1_model.next_event();
+            cycles t = std::min({ next_edge, t_tim3, t_tim2, next_systick, t_irq, t_change, t_usart, next_chatter,
+                chatter_end, home_at, host_read });
+            if (t > end) {
+                break;
+            }
+            now = t;
+            if (t == next_edge) {
+                s.count += direction;
+                uint64_t overruns = tim1_model.overruns;
+                tim1_model.count(direction);
+                if (tim1_model.overruns != overruns) {
+                    fault(s);
+                }
+                if (s.count % config.encoder == 0) { // index pulse once per revolution
+                    tim4_model.capture();
+                }
+                next_edge = to_cycles(s.next_edge(seconds(now), direction));
+            } else if (t == t_change) {
+                auto& c = config.changes[change++];
+                using devices::reg_settings_t;
+                if (c.num) {
+                    write_pitch(offsetof(devices::reg_pitch_t, pitch_num), c.num);
+                    write_pitch(offsetof(devices::reg_pitch_t, pitch_denom), c.denom);
+                }
+                write_setting(offsetof(reg_settings_t, mode), c.mode);
+                if (c.mode == 2) {
+                    write_setting(offsetof(reg_settings_t, target), c.target);
+                    write_setting(offsetof(reg_settings_t, move), c.move);
+                }
+                apply_registers();
+            } else if (t == next_systick) {
+                systick_pending = true;
+                next_systick += systick_period;
+            } else if (t == t_tim3) {
+                tim3_model.process();
+            } else if (t == t_tim2) {
+                tim2_model.process();
+            } else if (t == t_usart) {
+                usart1_model.process();
+            } else if (t == next_chatter) {
+                next_chatter += chatter_period;
+                if (chatter_end == never && chatter_width >= tim1_model.filter_window()) {
+                    stats.chatter_passed++;
+                    chatter(1);
+                    chatter_end = now + chatter_width;
+                } else {
+                    stats.chatter_rejected++;
+                }
+            } else if (t == chatter_end) {
+                chatter(-1);
+                chatter_end = never;
+            } else if (t == host_read) {
+                host_read = never;
+                read_event();
+            } else if (t == home_at) {
+                home_at = never;
+                stats.home_carriage = stats.carriage;
+                stats.home_count = s.count;
+                if (config.home_switch) {
+                    exti_falling(EXTI_PR_PR12);
+                } else {
+                    write_register(devices::i2c::Home_offset, devices::home::Now);
+                }
+            } else {
+                dispatch(select());
+            }
+            update_pending();
+            app::poll();
+            track_ratio(s);
+            track_control(s);
+            if (config.events_us >= 0 && host_read == never && !(GPIOB->ODR & GPIO_ODR_ODR13)) {
+                host_read = now + to_cycles(config.events_us * 1e-6);
+            }
+        }
+    }
+
+    void report(spindle& s) {
+        fprintf(stderr, "steps:                 %llu\n", static_cast<unsigned long long>(stats.steps));
+        fprintf(stderr, "final position:        %lld (ideal %.3f)\n", stats.carriage, ideal_position(s));
+        fprintf(stderr, "position error:        max %.3f, rms %.3f steps\n", stats.max_error,
+            stats.steps ? std::sqrt(stats.sum_error2 / stats.steps) : 0.0);
+        fprintf(stderr, "timing error:          max %.3f, rms %.3f us\n", stats.max_timing * 1e6,
+            stats.timed ? std::sqrt(stats.sum_timing2 / stats.timed) * 1e6 : 0.0);
+        if (stats.min_width != never) {
+            fprintf(stderr, "min step width:        %.3f us\n", seconds(stats.min_width) * 1e6);
+        }
+        if (stats.min_interval != never) {
+            fprintf(stderr, "max step rate:         %.0f steps/s\n", cpu_hz / static_cast<double>(stats.min_interval));
+        }
+        if (stats.min_setup != never) {
+            fprintf(stderr, "min dir setup:         %.3f us\n", seconds(stats.min_setup) * 1e6);
+        }
+        fprintf(stderr, "spindle count:         %lld (encoder %lld)\n",
+            static_cast<long long>(devices::encoder::get_extended_count()), s.count);
+        using rpm_sampler = devices::rpm_counter<>;
+        fprintf(stderr, "spindle speed:         %.1f rpm (estimate %.1f rpm, %.1f rpm/s)\n",
+            s.speed(seconds(now)) * 60.0 / s.resolution, rpm_sampler::get_decirpm(config.encoder) / 10.0,
+            rpm_sampler::get_acceleration(config.encoder) / 10.0);
+        fprintf(stderr, "leadscrew position:    %lld\n", static_cast<long long>(devices::step_gen::get_position()));
+        if (config.backlash) {
+            long long since_home = stats.carriage - (devices::home::homed ? stats.home_carriage : 0);
+            fprintf(stderr, "carriage position:     %lld (firmware %lld)\n", since_home,
+                static_cast<long long>(devices::step_gen::get_carriage_position()));
+        }
+        fprintf(stderr, "ignored step triggers: %llu\n", static_cast<unsigned long long>(tim3_model.ignored_triggers));
+        fprintf(stderr, "compare overruns:      %llu (firmware counted %u late)\n",
+            static_cast<unsigned long long>(tim1_model.overruns), static_cast<unsigned>(devices::encoder::overruns));
+        if (config.telemetry) {
+            fprintf(stderr, "telemetry records:     %llu (%u lost)\n",
+                static_cast<unsigned long long>(stats.telemetry_records),
+                static_cast<unsigned>(devices::telemetry::overflows));
+        }
+        if (config.chatter_hz > 0) {
+            fprintf(stderr, "chatter:               %llu passed, %llu rejected, %u glitches counted\n",
+                static_cast<unsigned long long>(stats.chatter_passed),
+                static_cast<unsigned long long>(stats.chatter_rejected),
+                static_cast<unsigned>(devices::encoder::glitches));
+        }
+        if (!std::isnan(config.home)) {
+            using devices::home;
+            fprintf(stderr, "home:                  %s, spindle angle %u (encoder %lld)\n", home::homed ? "set" : "not set",
+                static_cast<unsigned>(home::angle), (stats.home_count % config.encoder + config.encoder) % config.encoder);
+            int64_t carriage = devices::step_gen::get_carriage_position();
+            fprintf(stderr, "absolute position:     %lld steps, %d um (carriage %lld since home)\n",
+                static_cast<long long>(carriage), static_cast<int>(devices::i2c::micrometres(carriage)),
+                stats.carriage - stats.home_carriage);
+        }
+        if (config.events_us >= 0) {
+            fprintf(stderr, "events read:           %llu\n", static_cast<unsigned long long>(stats.events));
+        }
+        if (stats.faults) {
+            fprintf(stderr, "first fault at:        %.1f rpm\n", stats.first_fault_rpm);
+        }
+        for (auto& i : interrupts) {
+            if (i.calls) {
+                fprintf(stderr, "%-22s %llu calls, max latency %llu cycles\n", (std::string(i.name) + ":").c_str(),
+                    static_cast<unsigned long long>(i.calls), static_cast<unsigned long long>(i.max_latency));
+            }
+        }
+#ifdef MELS_PERF
+        const char* names[] = { "TIM1_CC", "TIM3", "I2C2_EV", "SysTick" };
+        devices::perf_record_t perf[devices::perf::handler_count];
+        devices::perf::read(perf);
+        for (uint8_t h = 0; h < devices::perf::handler_count; h++) {
+            auto& p = perf[h];
+            fprintf(stderr, "PERF %-17s min %u, max %u, mean %u cycles, histogram %u/%u/%u/%u\n",
+                (std::string(names[h]) + ":").c_str(), p.min_cycles, p.max_cycles, p.mean_cycles,
+                p.histogram[0], p.histogram[1], p.histogram[2], p.histogram[3]);
+        }
+#endif
+    }
+
+    // The expectations given on the command line, each failure is reported
+    bool check() {
+        bool ok = true;
+        auto expect = [&ok](bool met, const std::string& what, double value, double limit) {
+            if (!met) {
+                fprintf(stderr, "FAILED: %s %g, expected %g\n", what.c_str(), value, limit);
+                ok = false;
+            }
+        };
+        if (!std::isnan(config.max_error)) {
+            expect(stats.max_error <= config.max_error, "position error", stats.max_error, config.max_error);
+        }
+        if (!std::isnan(config.max_timing)) {
+            expect(stats.max_timing * 1e6 <= config.max_timing, "timing error", stats.max_timing * 1e6, config.max_timing);
+        }
+        if (config.max_latency >= 0) {
+            for (auto& i : interrupts) {
+                expect(static_cast<long long>(i.max_latency) <= config.max_latency, std::string(i.name) + " latency",
+                    static_cast<double>(i.max_latency), static_cast<double>(config.max_latency));
+            }
+        }
+        if (config.max_faults >= 0) {
+            uint64_t faults = tim3_model.ignored_triggers + tim1_model.overruns;
+            expect(faults <= static_cast<uint64_t>(config.max_faults), "faults", static_cast<double>(faults),
+                static_cast<double>(config.max_faults));
+        }
+        if (config.check_position) {
+            expect(stats.position == config.position, "leadscrew position", static_cast<double>(stats.position),
+                static_cast<double>(config.position));
+        }
+        return ok;
+    }
+
+    [[noreturn]] void usage(const char* error) {
+        fprintf(stderr, "m-els-sim: %s\n", error);
+        exit(2);
+    }
+
+    void parse(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                usage(("missing value for " + arg).c_str());
+            }
+            const char* value = argv[++i];
+            if (arg == "--encoder") {
+                config.encoder = static_cast<uint16_t>(atoi(value));
+            } else if (arg == "--stepper") {
+                config.stepper = static_cast<uint16_t>(atoi(value));
+            } else if (arg == "--gear") {
+                unsigned num, denom;
+                if (sscanf(value, "%u/%u", &num, &denom) != 2 || num == 0 || denom == 0) {
+                    usage("--gear expects NUM/DENOM");
+                }
+                config.num = num;
+                config.denom = denom;
+            } else if (arg == "--leadscrew") {
+                unsigned num, denom;
+                if (sscanf(value, "%u/%u", &num, &denom) != 2 || num == 0 || denom == 0) {
+                    usage("--leadscrew expects NUM/DENOM");
+                }
+                config.leadscrew_num = num;
+                config.leadscrew_denom = denom;
+            } else if (arg == "--preset") {
+                config.preset = static_cast<uint8_t>(atoi(value));
+            } else if (arg == "--profile") {
+                config.profile.clear();
+                for (const char* p = value; *p;) {
+                    double t, rpm;
+                    int used;
+                    if (sscanf(p, "%lf:%lf%n", &t, &rpm, &used) != 2) {
+                        usage("--profile expects T:RPM,...");
+                    }
+                    config.profile.push_back({ t, rpm });
+                    p += used;
+                    if (*p == ',') {
+                        p++;
+                    }
+                }
+            } else if (arg == "--latency") {
+                config.latency = strtoull(value, nullptr, 10);
+            } else if (arg == "--isr") {
+                const char* eq = strchr(value, '=');
+                bool found = false;
+                for (auto& irq : interrupts) {
+                    if (eq && std::string(value, eq) == irq.name) {
+                        irq.cost = strtoull(eq + 1, nullptr, 10);
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    usage("--isr expects NAME=CYCLES");
+                }
+            } else if (arg == "--change") {
+                for (const char* p = value; *p;) {
+                    double t;
+                    unsigned num, denom;
+                    int used;
+                    if (sscanf(p, "%lf:%u/%u%n", &t, &num, &denom, &used) != 3 || num == 0 || denom == 0) {
+                        usage("--change expects T:NUM/DENOM,...");
+                    }
+                    config.changes.push_back({ t, num, denom, 1 });
+                    p += used;
+                    if (*p == ',') {
+                        p++;
+                    }
+                }
+            } else if (arg == "--move" || arg == "--rapid") {
+                for (const char* p = value; *p;) {
+                    double t;
+                    int target;
+                    int used;
+                    if (sscanf(p, "%lf:%d%n", &t, &target, &used) != 2) {
+                        usage((arg + " expects T:TARGET,...").c_str());
+                    }
+                    config.changes.push_back({ t, 0, 0, 2, target, static_cast<uint8_t>(arg == "--move" ? 1 : 2) });
+                    p += used;
+                    if (*p == ',') {
+                        p++;
+                    }
+                }
+            } else if (arg == "--thread") {
+                unsigned starts, start;
+                if (sscanf(value, "%u/%u", &starts, &start) != 2 || starts == 0 || start >= starts) {
+                    usage("--thread expects STARTS/START");
+                }
+                config.thread_starts = static_cast<uint8_t>(starts);
+                config.thread_start = static_cast<uint8_t>(start);
+            } else if (arg == "--engage") {
+                config.engage = atof(value);
+            } else if (arg == "--timeline") {
+                config.timeline = strcmp(value, "-") == 0 ? stdout : fopen(value, "w");
+                if (!config.timeline) {
+                    usage("cannot open timeline file");
+                }
+            } else if (arg == "--max-error") {
+                config.max_error = atof(value);
+            } else if (arg == "--max-timing") {
+                config.max_timing = atof(value);
+            } else if (arg == "--max-latency") {
+                config.max_latency = atoll(value);
+            } else if (arg == "--max-faults") {
+                config.max_faults = atoll(value);
+            } else if (arg == "--position") {
+                config.check_position = true;
+                config.position = atoll(value);
+            } else if (arg == "--backlash") {
+                config.backlash = atoi(value);
+            } else if (arg == "--deadband") {
+                config.deadband = atoi(value);
+            } else if (arg == "--left-limit") {
+                config.limits |= limit::Left;
+                config.left_limit = atol(value);
+            } else if (arg == "--right-limit") {
+                config.limits |= limit::Right;
+                config.right_limit = atol(value);
+            } else if (arg == "--home" || arg == "--home-switch") {
+                config.home = atof(value);
+                config.home_switch = arg == "--home-switch";
+            } else if (arg == "--events") {
+                config.events_us = atof(value);
+            } else if (arg == "--chatter") {
+                if (sscanf(value, "%lf:%lf", &config.chatter_hz, &config.chatter_us) != 2 || config.chatter_hz <= 0) {
+                    usage("--chatter expects HZ:US");
+                }
+            } else if (arg == "--telemetry") {
+                config.telemetry = strcmp(value, "-") == 0 ? stdout : fopen(value, "w");
+                if (!config.telemetry) {
+                    usage("cannot open telemetry file");
+                }
+            } else {
+                usage(("unknown option " + arg).c_str());
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace sim;
+    parse(argc, argv);
+
+    spindle s(config.profile, config.encoder);
+    tools::log_decoder log;
+    probe.uart = [&log](char ch) {
+        if (!log.feed(static_cast<uint8_t>(ch))) {
+            return;
+        }
+        devices::telemetry_record_t r;
+        if (config.telemetry && log.telemetry(r)) {
+            stats.telemetry_records++;
+            fprintf(config.telemetry, "%.9f,%s\n", seconds(now), log.csv(r).c_str());
+        } else {
+            fprintf(stderr, "[%10.6f] %s\n", seconds(now), log.text().c_str());
+        }
+    };
+    probe.step = [&s](bool active, bool) { on_step(active, s); };
+    probe.dir = [&s](bool level) {
+        stats.last_dir_change = now;
+        write_edge("dir", level, ideal_position(s));
+    };
+
+    app::init();
+
+    using devices::reg_configuration_t;
+    using devices::reg_settings_t;
+    write_configuration(offsetof(reg_configuration_t, encoder_resolution), config.encoder);
+    write_configuration(offsetof(reg_configuration_t, stepper_resolution), config.stepper);
+    write_configuration(offsetof(reg_configuration_t, thread_starts), config.thread_starts);
+    write_configuration(offsetof(reg_configuration_t, thread_start), config.thread_start);
+    using devices::reg_pitch_t;
+    write_pitch(offsetof(reg_pitch_t, pitch_num), config.num);
+    write_pitch(offsetof(reg_pitch_t, pitch_denom), config.denom);
+    write_pitch(offsetof(reg_pitch_t, leadscrew_num), config.leadscrew_num);
+    write_pitch(offsetof(reg_pitch_t, leadscrew_denom), config.leadscrew_denom);
+    write_setting(offsetof(reg_settings_t, preset), config.preset);
+    using devices::reg_motion_t;
+    write_register(devices::i2c::Motion_offset + offsetof(reg_motion_t, backlash), config.backlash);
+    write_register(devices::i2c::Motion_offset + offsetof(reg_motion_t, deadband), config.deadband);
+    write_register(devices::i2c::Motion_offset + offsetof(reg_motion_t, limits), config.limits);
+    write_register(devices::i2c::Motion_offset + offsetof(reg_motion_t, left_limit), config.left_limit);
+    write_register(devices::i2c::Motion_offset + offsetof(reg_motion_t, right_limit), config.right_limit);
+    bool moves = std::any_of(config.changes.begin(), config.changes.end(), [](auto& c) { return c.mode == 2; });
+    write_setting(offsetof(reg_settings_t, mode), static_cast<char>(config.engage > 0 ? 0 : moves ? 2 : 1));
+    apply_registers();
+    if (config.home_switch) {
+        write_register(devices::i2c::Home_offset, devices::home::On_switch);
+    }
+    if (config.engage > 0) {
+        for (auto& c : config.changes) {
+            if (c.mode != 2) {
+                c.mode = c.time < config.engage ? 0 : 1;
+            }
+        }
+        config.changes.push_back({ config.engage, 0, 0, 1 });
+    }
+    std::stable_sort(config.changes.begin(), config.changes.end(),
+        [](auto& a, auto& b) { return a.time < b.time; });
+
+    if (config.timeline) {
+        fprintf(config.timeline, "time_ns,signal,level,encoder_count,position,ideal_position\n");
+    }
+    if (config.telemetry) {
+        fprintf(config.telemetry, "time,%s\n", log.Csv_header);
+        write_register(devices::i2c::Telemetry_offset, uint8_t{ 1 });
+    }
+    app::poll();
+    track_ratio(s);
+    track_control(s);
+    run(s);
+    report(s);
+    if (config.timeline && config.timeline != stdout) {
+        fclose(config.timeline);
+    }
+    if (config.telemetry && config.telemetry != stdout) {
+        fclose(config.telemetry);
+    }
+    return check() ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#pragma once
+// Virtual spindle with a quadrature encoder attached.
+//
+// The speed follows a piecewise linear profile in RPM (negative for reverse),
+// so the angle within a segment is quadratic in time and every encoder
+// transition can be solved for exactly.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace sim {
+
+    struct spindle {
+        struct point {
+            double time; // s
+            double rpm;
+        };
+
+        std::vector<point> profile;
+        double resolution; // encoder transitions per revolution
+        std::vector<double> start_position; // transitions at the start of each segment
+        long long count = 0; // floor of the position
+
+        spindle(std::vector<point> p, double res) : profile(std::move(p)), resolution(res) {
+            if (profile.size() == 1) {
+                profile.push_back({ profile[0].time + 1.0, profile[0].rpm });
+            }
+            start_position.push_back(0.0);
+            for (size_t i = 0; i + 1 < profile.size(); i++) {
+                start_position.push_back(start_position[i] + travel(i, duration(i)));
+            }
+        }
+
+        double end_time() const {
+            return profile.back().time;
+        }
+
+        double duration(size_t seg) const {
+            return profile[seg + 1].time - profile[seg].time;
+        }
+
+        // transitions per second at the start of a segment and its derivative
+        double start_speed(size_t seg) const {
+            return profile[seg].rpm * resolution / 60.0;
+        }
+
+        double acceleration(size_t seg) const {
+            double d = duration(seg);
+            return d > 0 ? (profile[seg + 1].rpm - profile[seg].rpm) * resolution / 60.0 / d : 0.0;
+        }
+
+        double travel(size_t seg, double tau) const {
+            return start_speed(seg) * tau + 0.5 * acceleration(seg) * tau * tau;
+        }
+
+        size_t segment(double t) const {
+            size_t seg = 0;
+            while (seg + 2 < profile.size() && t >= profile[seg + 1].time) {
+                seg++;
+            }
+            return seg;
+        }
+
+        double position(double t) const {
+            size_t seg = segment(t);
+            double tau = std::min(std::max(t - profile[seg].time, 0.0), duration(seg));
+            return start_position[seg] + travel(seg, tau);
+        }
+
+        double speed(double t) const {
+            size_t seg = segment(t);
+            double tau = std::min(std::max(t - profile[seg].time, 0.0), duration(seg));
+            return start_speed(seg) + acceleration(seg) * tau;
+        }
+
+        // Earliest time after `after` within the segment where the position
+        // reaches `target` while moving in the given direction
+        double crossing(size_t seg, double target, bool rising, double after) const {
+            const double none = std::numeric_limits<double>::infinity();
+            double t0 = profile[seg].time;
+            double lo = std::max(after - t0, 0.0);
+            double hi = duration(seg);
+            double a = 0.5 * acceleration(seg);
+            double b = start_speed(seg);
+            double c = start_position[seg] - target;
+            double roots[2];
+            int n = 0;
+            if (a == 0.0) {
+                if (b != 0.0) {
+                    roots[n++] = -c / b;
+                }
+            } else {
+                double disc = b * b - 4 * a * c;
+                if (disc >= 0) {
+                    double q = -0.5 * (b + std::copysign(std::sqrt(disc), b));
+                    if (q != 0.0) {
+                        roots[n++] = c / q;
+                    }
+                    roots[n++] = q / a;
+                }
+            }
+            double best = none;
+            for (int i = 0; i < n; i++) {
+                double tau = roots[i];
+                double v = b + 2 * a * tau;
+                if (v == 0.0) {
+                    v = a; // starting from standstill
+                }
+                // a root right at the start of the run counts, e.g. reversing from standstill at 0
+                bool started = tau > lo || (tau == 0 && after <= 0);
+                if (started && tau <= hi && (rising ? v > 0 : v < 0)) {
+                    best = std::min(best, t0 + tau);
+                }
+            }
+            return best;
+        }
+
+        // Time and direction of the next encoder transition
+        double next_edge(double after, int& direction) const {
+            for (size_t seg = segment(after); seg + 1 < profile.size(); seg++) {
+                double up = crossing(seg, static_cast<double>(count + 1), true, after);
+                double down = crossing(seg, static_cast<double>(count), false, after);
+                if (up != std::numeric_limits<double>::infinity() || down != std::numeric_limits<double>::infinity()) {
+                    direction = up <= down ? 1 : -1;
+                    return std::min(up, down);
+                }
+            }
+            direction = 0;
+            return std::numeric_limits<double>::infinity();
+        }
+    };
+}
@@ -0,0 +1,1730 @@
+#pragma once
+// Host stand-in for the CMSIS STM32F103xB device header.
+//
+// The register layouts mirror the reference manual so the firmware compiles
+// unchanged; registers whose writes have side effects on the simulated
+// hardware (timer control and events, compare modes, GPIO outputs, UART data,
+// DMA and EXTI flag clears, software interrupts) are
+// `sim::reg` and notify the peripheral model in sim/peripherals.hpp.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+    inline void register_written(const volatile void* reg, uint32_t previous, uint32_t value);
+    inline uint32_t cycle_count();
+
+    struct reg {
+        uint32_t value;
+
+        operator uint32_t() const volatile { return value; }
+        void operator=(uint32_t v) volatile { write(v); }
+        void operator|=(uint32_t v) volatile { write(value | v); }
+        void operator&=(uint32_t v) volatile { write(value & v); }
+        void operator^=(uint32_t v) volatile { write(value ^ v); }
+
+    private:
+        void write(uint32_t v) volatile {
+            uint32_t previous = value;
+            value = v;
+            register_written(this, previous, v);
+        }
+    };
+
+    // DWT->CYCCNT, reads come from the simulated CPU clock
+    struct cycle_counter {
+        operator uint32_t() const volatile { return cycle_count(); }
+        void operator=(uint32_t) volatile {}
+    };
+}
+
+#define __IO volatile
+
+typedef enum {
+    SysTick_IRQn = -1,
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    DMA1_Channel1_IRQn = 11,
+    DMA1_Channel2_IRQn = 12,
+    DMA1_Channel3_IRQn = 13,
+    DMA1_Channel4_IRQn = 14,
+    DMA1_Channel5_IRQn = 15,
+    DMA1_Channel6_IRQn = 16,
+    DMA1_Channel7_IRQn = 17,
+    EXTI9_5_IRQn = 23,
+    TIM1_BRK_IRQn = 24,
+    TIM1_UP_IRQn = 25,
+    TIM1_TRG_COM_IRQn = 26,
+    TIM1_CC_IRQn = 27,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    TIM4_IRQn = 30,
+    I2C1_EV_IRQn = 31,
+    I2C1_ER_IRQn = 32,
+    I2C2_EV_IRQn = 33,
+    I2C2_ER_IRQn = 34,
+    USART1_IRQn = 37,
+    USART2_IRQn = 38,
+    USART3_IRQn = 39,
+    EXTI15_10_IRQn = 40,
+} IRQn_Type;
+
+typedef struct {
+    __IO sim::reg CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SMCR;
+    __IO uint32_t DIER;
+    __IO uint32_t SR;
+    __IO sim::reg EGR;
+    __IO uint32_t CCMR1;
+    __IO sim::reg CCMR2;
+    __IO uint32_t CCER;
+    __IO uint32_t CNT;
+    __IO uint32_t PSC;
+    __IO uint32_t ARR;
+    __IO uint32_t RCR;
+    __IO uint32_t CCR1;
+    __IO uint32_t CCR2;
+    __IO uint32_t CCR3;
+    __IO uint32_t CCR4;
+    __IO uint32_t BDTR;
+    __IO uint32_t DCR;
+    __IO uint32_t DMAR;
+    __IO uint32_t OR;
+} TIM_TypeDef;
+
+typedef struct {
+    __IO uint32_t CRL;
+    __IO uint32_t CRH;
+    __IO uint32_t IDR;
+    __IO sim::reg ODR;
+    __IO sim::reg BSRR;
+    __IO sim::reg BRR;
+    __IO uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef struct {
+    __IO uint32_t EVCR;
+    __IO uint32_t MAPR;
+    __IO uint32_t EXTICR[4];
+    uint32_t RESERVED0;
+    __IO uint32_t MAPR2;
+} AFIO_TypeDef;
+
+typedef struct {
+    __IO uint32_t IMR;
+    __IO uint32_t EMR;
+    __IO uint32_t RTSR;
+    __IO uint32_t FTSR;
+    __IO sim::reg SWIER;
+    __IO sim::reg PR;
+} EXTI_TypeDef;
+
+typedef struct {
+    __IO uint32_t ISR;
+    __IO sim::reg IFCR;
+} DMA_TypeDef;
+
+// Address registers are pointer sized so host addresses fit
+typedef struct {
+    __IO sim::reg CCR;
+    __IO uint32_t CNDTR;
+    __IO uintptr_t CPAR;
+    __IO uintptr_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t OAR1;
+    __IO uint32_t OAR2;
+    __IO uint32_t DR;
+    __IO uint32_t SR1;
+    __IO uint32_t SR2;
+    __IO uint32_t CCR;
+    __IO uint32_t TRISE;
+} I2C_TypeDef;
+
+typedef struct {
+    __IO uint32_t SR;
+    __IO sim::reg DR;
+    __IO uint32_t BRR;
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t CR3;
+    __IO uint32_t GTPR;
+} USART_TypeDef;
+
+typedef struct {
+    __IO uint32_t CR;
+    __IO uint32_t CFGR;
+    __IO uint32_t CIR;
+    __IO uint32_t APB2RSTR;
+    __IO uint32_t APB1RSTR;
+    __IO uint32_t AHBENR;
+    __IO uint32_t APB2ENR;
+    __IO uint32_t APB1ENR;
+    __IO uint32_t BDCR;
+    __IO uint32_t CSR;
+} RCC_TypeDef;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __IO uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    sim::cycle_counter CYCCNT;
+    __IO uint32_t CPICNT;
+    __IO uint32_t EXCCNT;
+    __IO uint32_t SLEEPCNT;
+    __IO uint32_t LSUCNT;
+    __IO uint32_t FOLDCNT;
+    __IO uint32_t PCSR;
+} DWT_Type;
+
+typedef struct {
+    __IO uint32_t DHCSR;
+    __IO uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+namespace sim {
+    // Reset values as listed in the reference manual
+    inline TIM_TypeDef tim1{ {}, 0, 0, 0, 0, 0, 0, {}, 0, 0, 0, 0xFFFF };
+    inline TIM_TypeDef tim2{ {}, 0, 0, 0, 0, 0, 0, {}, 0, 0, 0, 0xFFFF };
+    inline TIM_TypeDef tim3{ {}, 0, 0, 0, 0, 0, 0, {}, 0, 0, 0, 0xFFFF };
+    inline TIM_TypeDef tim4{ {}, 0, 0, 0, 0, 0, 0, {}, 0, 0, 0, 0xFFFF };
+    inline GPIO_TypeDef gpioa{ 0x44444444, 0x44444444 };
+    inline GPIO_TypeDef gpiob{ 0x44444444, 0x44444444 };
+    inline GPIO_TypeDef gpioc{ 0x44444444, 0x44444444 };
+    inline AFIO_TypeDef afio{};
+    inline EXTI_TypeDef exti{};
+    inline DMA_TypeDef dma1{};
+    inline DMA_Channel_TypeDef dma1_channel[7]{};
+    inline I2C_TypeDef i2c1{};
+    inline I2C_TypeDef i2c2{};
+    inline USART_TypeDef usart1{ 0x00C0 };
+    inline USART_TypeDef usart2{ 0x00C0 };
+    inline RCC_TypeDef rcc{};
+    inline SysTick_Type systick{};
+    inline DWT_Type dwt{};
+    inline CoreDebug_Type core_debug{};
+
+    struct nvic_state {
+        bool enabled[64];
+        uint8_t priority[64];
+        bool pending[64]; // latched from the interrupt line, cleared when the handler is entered
+    };
+    inline nvic_state nvic{};
+    inline uint32_t primask = 0;
+}
+
+#define TIM1 (&sim::tim1)
+#define TIM2 (&sim::tim2)
+#define TIM3 (&sim::tim3)
+#define TIM4 (&sim::tim4)
+#define GPIOA (&sim::gpioa)
+#define GPIOB (&sim::gpiob)
+#define GPIOC (&sim::gpioc)
+#define AFIO (&sim::afio)
+#define EXTI (&sim::exti)
+#define DMA1 (&sim::dma1)
+#define DMA1_Channel1 (&sim::dma1_channel[0])
+#define DMA1_Channel2 (&sim::dma1_channel[1])
+#define DMA1_Channel3 (&sim::dma1_channel[2])
+#define DMA1_Channel4 (&sim::dma1_channel[3])
+#define DMA1_Channel5 (&sim::dma1_channel[4])
+#define DMA1_Channel6 (&sim::dma1_channel[5])
+#define DMA1_Channel7 (&sim::dma1_channel[6])
+#define I2C1 (&sim::i2c1)
+#define I2C2 (&sim::i2c2)
+#define USART1 (&sim::usart1)
+#define USART2 (&sim::usart2)
+#define RCC (&sim::rcc)
+#define SysTick (&sim::systick)
+#define DWT (&sim::dwt)
+#define CoreDebug (&sim::core_debug)
+
+#define DWT_CTRL_CYCCNTENA_Pos 0U
+#define DWT_CTRL_CYCCNTENA_Msk (0x1U << DWT_CTRL_CYCCNTENA_Pos)
+#define CoreDebug_DEMCR_TRCENA_Pos 24U
+#define CoreDebug_DEMCR_TRCENA_Msk (0x1U << CoreDebug_DEMCR_TRCENA_Pos)
+
+// Handlers run to completion between main loop steps in the simulation, so
+// masking only has to be remembered
+inline uint32_t __get_PRIMASK() {
+    return sim::primask;
+}
+
+inline void __set_PRIMASK(uint32_t mask) {
+    sim::primask = mask;
+}
+
+inline void __disable_irq() {
+    sim::primask = 1;
+}
+
+inline void __enable_irq() {
+    sim::primask = 0;
+}
+
+inline void NVIC_EnableIRQ(IRQn_Type irq) {
+    if (irq >= 0) {
+        sim::nvic.enabled[irq] = true;
+    }
+}
+
+inline void NVIC_DisableIRQ(IRQn_Type irq) {
+    if (irq >= 0) {
+        sim::nvic.enabled[irq] = false;
+    }
+}
+
+inline void NVIC_ClearPendingIRQ(IRQn_Type irq) {
+    if (irq >= 0) {
+        sim::nvic.pending[irq] = false;
+    }
+}
+
+inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    if (irq >= 0) {
+        sim::nvic.priority[irq] = static_cast<uint8_t>(priority);
+    }
+}
+
+// TIM CR1
+#define TIM_CR1_CEN_Pos (0U)
+#define TIM_CR1_CEN_Msk (0x1U << TIM_CR1_CEN_Pos)
+#define TIM_CR1_CEN TIM_CR1_CEN_Msk
+#define TIM_CR1_UDIS_Pos (1U)
+#define TIM_CR1_UDIS_Msk (0x1U << TIM_CR1_UDIS_Pos)
+#define TIM_CR1_UDIS TIM_CR1_UDIS_Msk
+#define TIM_CR1_URS_Pos (2U)
+#define TIM_CR1_URS_Msk (0x1U << TIM_CR1_URS_Pos)
+#define TIM_CR1_URS TIM_CR1_URS_Msk
+#define TIM_CR1_OPM_Pos (3U)
+#define TIM_CR1_OPM_Msk (0x1U << TIM_CR1_OPM_Pos)
+#define TIM_CR1_OPM TIM_CR1_OPM_Msk
+#define TIM_CR1_DIR_Pos (4U)
+#define TIM_CR1_DIR_Msk (0x1U << TIM_CR1_DIR_Pos)
+#define TIM_CR1_DIR TIM_CR1_DIR_Msk
+#define TIM_CR1_CMS_Pos (5U)
+#define TIM_CR1_CMS_Msk (0x3U << TIM_CR1_CMS_Pos)
+#define TIM_CR1_CMS TIM_CR1_CMS_Msk
+#define TIM_CR1_CMS_0 (0x1U << (TIM_CR1_CMS_Pos + 0U))
+#define TIM_CR1_CMS_1 (0x1U << (TIM_CR1_CMS_Pos + 1U))
+#define TIM_CR1_ARPE_Pos (7U)
+#define TIM_CR1_ARPE_Msk (0x1U << TIM_CR1_ARPE_Pos)
+#define TIM_CR1_ARPE TIM_CR1_ARPE_Msk
+#define TIM_CR1_CKD_Pos (8U)
+#define TIM_CR1_CKD_Msk (0x3U << TIM_CR1_CKD_Pos)
+#define TIM_CR1_CKD TIM_CR1_CKD_Msk
+#define TIM_CR1_CKD_0 (0x1U << (TIM_CR1_CKD_Pos + 0U))
+#define TIM_CR1_CKD_1 (0x1U << (TIM_CR1_CKD_Pos + 1U))
+
+// TIM CR2
+#define TIM_CR2_CCDS_Pos (3U)
+#define TIM_CR2_CCDS_Msk (0x1U << TIM_CR2_CCDS_Pos)
+#define TIM_CR2_CCDS TIM_CR2_CCDS_Msk
+#define TIM_CR2_MMS_Pos (4U)
+#define TIM_CR2_MMS_Msk (0x7U << TIM_CR2_MMS_Pos)
+#define TIM_CR2_MMS TIM_CR2_MMS_Msk
+#define TIM_CR2_MMS_0 (0x1U << (TIM_CR2_MMS_Pos + 0U))
+#define TIM_CR2_MMS_1 (0x1U << (TIM_CR2_MMS_Pos + 1U))
+#define TIM_CR2_MMS_2 (0x1U << (TIM_CR2_MMS_Pos + 2U))
+#define TIM_CR2_TI1S_Pos (7U)
+#define TIM_CR2_TI1S_Msk (0x1U << TIM_CR2_TI1S_Pos)
+#define TIM_CR2_TI1S TIM_CR2_TI1S_Msk
+
+// TIM SMCR
+#define TIM_SMCR_SMS_Pos (0U)
+#define TIM_SMCR_SMS_Msk (0x7U << TIM_SMCR_SMS_Pos)
+#define TIM_SMCR_SMS TIM_SMCR_SMS_Msk
+#define TIM_SMCR_SMS_0 (0x1U << (TIM_SMCR_SMS_Pos + 0U))
+#define TIM_SMCR_SMS_1 (0x1U << (TIM_SMCR_SMS_Pos + 1U))
+#define TIM_SMCR_SMS_2 (0x1U << (TIM_SMCR_SMS_Pos + 2U))
+#define TIM_SMCR_TS_Pos (4U)
+#define TIM_SMCR_TS_Msk (0x7U << TIM_SMCR_TS_Pos)
+#define TIM_SMCR_TS TIM_SMCR_TS_Msk
+#define TIM_SMCR_TS_0 (0x1U << (TIM_SMCR_TS_Pos + 0U))
+#define TIM_SMCR_TS_1 (0x1U << (TIM_SMCR_TS_Pos + 1U))
+#define TIM_SMCR_TS_2 (0x1U << (TIM_SMCR_TS_Pos + 2U))
+#define TIM_SMCR_MSM_Pos (7U)
+#define TIM_SMCR_MSM_Msk (0x1U << TIM_SMCR_MSM_Pos)
+#define TIM_SMCR_MSM TIM_SMCR_MSM_Msk
+#define TIM_SMCR_ETF_Pos (8U)
+#define TIM_SMCR_ETF_Msk (0xFU << TIM_SMCR_ETF_Pos)
+#define TIM_SMCR_ETF TIM_SMCR_ETF_Msk
+#define TIM_SMCR_ETF_0 (0x1U << (TIM_SMCR_ETF_Pos + 0U))
+#define TIM_SMCR_ETF_1 (0x1U << (TIM_SMCR_ETF_Pos + 1U))
+#define TIM_SMCR_ETF_2 (0x1U << (TIM_SMCR_ETF_Pos + 2U))
+#define TIM_SMCR_ETF_3 (0x1U << (TIM_SMCR_ETF_Pos + 3U))
+#define TIM_SMCR_ETPS_Pos (12U)
+#define TIM_SMCR_ETPS_Msk (0x3U << TIM_SMCR_ETPS_Pos)
+#define TIM_SMCR_ETPS TIM_SMCR_ETPS_Msk
+#define TIM_SMCR_ETPS_0 (0x1U << (TIM_SMCR_ETPS_Pos + 0U))
+#define TIM_SMCR_ETPS_1 (0x1U << (TIM_SMCR_ETPS_Pos + 1U))
+#define TIM_SMCR_ECE_Pos (14U)
+#define TIM_SMCR_ECE_Msk (0x1U << TIM_SMCR_ECE_Pos)
+#define TIM_SMCR_ECE TIM_SMCR_ECE_Msk
+#define TIM_SMCR_ETP_Pos (15U)
+#define TIM_SMCR_ETP_Msk (0x1U << TIM_SMCR_ETP_Pos)
+#define TIM_SMCR_ETP TIM_SMCR_ETP_Msk
+
+// TIM DIER
+#define TIM_DIER_UIE_Pos (0U)
+#define TIM_DIER_UIE_Msk (0x1U << TIM_DIER_UIE_Pos)
+#define TIM_DIER_UIE TIM_DIER_UIE_Msk
+#define TIM_DIER_CC1IE_Pos (1U)
+#define TIM_DIER_CC1IE_Msk (0x1U << TIM_DIER_CC1IE_Pos)
+#define TIM_DIER_CC1IE TIM_DIER_CC1IE_Msk
+#define TIM_DIER_CC2IE_Pos (2U)
+#define TIM_DIER_CC2IE_Msk (0x1U << TIM_DIER_CC2IE_Pos)
+#define TIM_DIER_CC2IE TIM_DIER_CC2IE_Msk
+#define TIM_DIER_CC3IE_Pos (3U)
+#define TIM_DIER_CC3IE_Msk (0x1U << TIM_DIER_CC3IE_Pos)
+#define TIM_DIER_CC3IE TIM_DIER_CC3IE_Msk
+#define TIM_DIER_CC4IE_Pos (4U)
+#define TIM_DIER_CC4IE_Msk (0x1U << TIM_DIER_CC4IE_Pos)
+#define TIM_DIER_CC4IE TIM_DIER_CC4IE_Msk
+#define TIM_DIER_COMIE_Pos (5U)
+#define TIM_DIER_COMIE_Msk (0x1U << TIM_DIER_COMIE_Pos)
+#define TIM_DIER_COMIE TIM_DIER_COMIE_Msk
+#define TIM_DIER_TIE_Pos (6U)
+#define TIM_DIER_TIE_Msk (0x1U << TIM_DIER_TIE_Pos)
+#define TIM_DIER_TIE TIM_DIER_TIE_Msk
+#define TIM_DIER_BIE_Pos (7U)
+#define TIM_DIER_BIE_Msk (0x1U << TIM_DIER_BIE_Pos)
+#define TIM_DIER_BIE TIM_DIER_BIE_Msk
+#define TIM_DIER_UDE_Pos (8U)
+#define TIM_DIER_UDE_Msk (0x1U << TIM_DIER_UDE_Pos)
+#define TIM_DIER_UDE TIM_DIER_UDE_Msk
+#define TIM_DIER_CC1DE_Pos (9U)
+#define TIM_DIER_CC1DE_Msk (0x1U << TIM_DIER_CC1DE_Pos)
+#define TIM_DIER_CC1DE TIM_DIER_CC1DE_Msk
+#define TIM_DIER_CC2DE_Pos (10U)
+#define TIM_DIER_CC2DE_Msk (0x1U << TIM_DIER_CC2DE_Pos)
+#define TIM_DIER_CC2DE TIM_DIER_CC2DE_Msk
+#define TIM_DIER_CC3DE_Pos (11U)
+#define TIM_DIER_CC3DE_Msk (0x1U << TIM_DIER_CC3DE_Pos)
+#define TIM_DIER_CC3DE TIM_DIER_CC3DE_Msk
+#define TIM_DIER_CC4DE_Pos (12U)
+#define TIM_DIER_CC4DE_Msk (0x1U << TIM_DIER_CC4DE_Pos)
+#define TIM_DIER_CC4DE TIM_DIER_CC4DE_Msk
+#define TIM_DIER_COMDE_Pos (13U)
+#define TIM_DIER_COMDE_Msk (0x1U << TIM_DIER_COMDE_Pos)
+#define TIM_DIER_COMDE TIM_DIER_COMDE_Msk
+#define TIM_DIER_TDE_Pos (14U)
+#define TIM_DIER_TDE_Msk (0x1U << TIM_DIER_TDE_Pos)
+#define TIM_DIER_TDE TIM_DIER_TDE_Msk
+
+// TIM SR
+#define TIM_SR_UIF_Pos (0U)
+#define TIM_SR_UIF_Msk (0x1U << TIM_SR_UIF_Pos)
+#define TIM_SR_UIF TIM_SR_UIF_Msk
+#define TIM_SR_CC1IF_Pos (1U)
+#define TIM_SR_CC1IF_Msk (0x1U << TIM_SR_CC1IF_Pos)
+#define TIM_SR_CC1IF TIM_SR_CC1IF_Msk
+#define TIM_SR_CC2IF_Pos (2U)
+#define TIM_SR_CC2IF_Msk (0x1U << TIM_SR_CC2IF_Pos)
+#define TIM_SR_CC2IF TIM_SR_CC2IF_Msk
+#define TIM_SR_CC3IF_Pos (3U)
+#define TIM_SR_CC3IF_Msk (0x1U << TIM_SR_CC3IF_Pos)
+#define TIM_SR_CC3IF TIM_SR_CC3IF_Msk
+#define TIM_SR_CC4IF_Pos (4U)
+#define TIM_SR_CC4IF_Msk (0x1U << TIM_SR_CC4IF_Pos)
+#define TIM_SR_CC4IF TIM_SR_CC4IF_Msk
+#define TIM_SR_COMIF_Pos (5U)
+#define TIM_SR_COMIF_Msk (0x1U << TIM_SR_COMIF_Pos)
+#define TIM_SR_COMIF TIM_SR_COMIF_Msk
+#define TIM_SR_TIF_Pos (6U)
+#define TIM_SR_TIF_Msk (0x1U << TIM_SR_TIF_Pos)
+#define TIM_SR_TIF TIM_SR_TIF_Msk
+#define TIM_SR_BIF_Pos (7U)
+#define TIM_SR_BIF_Msk (0x1U << TIM_SR_BIF_Pos)
+#define TIM_SR_BIF TIM_SR_BIF_Msk
+#define TIM_SR_CC1OF_Pos (9U)
+#define TIM_SR_CC1OF_Msk (0x1U << TIM_SR_CC1OF_Pos)
+#define TIM_SR_CC1OF TIM_SR_CC1OF_Msk
+#define TIM_SR_CC2OF_Pos (10U)
+#define TIM_SR_CC2OF_Msk (0x1U << TIM_SR_CC2OF_Pos)
+#define TIM_SR_CC2OF TIM_SR_CC2OF_Msk
+#define TIM_SR_CC3OF_Pos (11U)
+#define TIM_SR_CC3OF_Msk (0x1U << TIM_SR_CC3OF_Pos)
+#define TIM_SR_CC3OF TIM_SR_CC3OF_Msk
+#define TIM_SR_CC4OF_Pos (12U)
+#define TIM_SR_CC4OF_Msk (0x1U << TIM_SR_CC4OF_Pos)
+#define TIM_SR_CC4OF TIM_SR_CC4OF_Msk
+
+// TIM EGR
+#define TIM_EGR_UG_Pos (0U)
+#define TIM_EGR_UG_Msk (0x1U << TIM_EGR_UG_Pos)
+#define TIM_EGR_UG TIM_EGR_UG_Msk
+#define TIM_EGR_CC1G_Pos (1U)
+#define TIM_EGR_CC1G_Msk (0x1U << TIM_EGR_CC1G_Pos)
+#define TIM_EGR_CC1G TIM_EGR_CC1G_Msk
+#define TIM_EGR_CC2G_Pos (2U)
+#define TIM_EGR_CC2G_Msk (0x1U << TIM_EGR_CC2G_Pos)
+#define TIM_EGR_CC2G TIM_EGR_CC2G_Msk
+#define TIM_EGR_CC3G_Pos (3U)
+#define TIM_EGR_CC3G_Msk (0x1U << TIM_EGR_CC3G_Pos)
+#define TIM_EGR_CC3G TIM_EGR_CC3G_Msk
+#define TIM_EGR_CC4G_Pos (4U)
+#define TIM_EGR_CC4G_Msk (0x1U << TIM_EGR_CC4G_Pos)
+#define TIM_EGR_CC4G TIM_EGR_CC4G_Msk
+#define TIM_EGR_COMG_Pos (5U)
+#define TIM_EGR_COMG_Msk (0x1U << TIM_EGR_COMG_Pos)
+#define TIM_EGR_COMG TIM_EGR_COMG_Msk
+#define TIM_EGR_TG_Pos (6U)
+#define TIM_EGR_TG_Msk (0x1U << TIM_EGR_TG_Pos)
+#define TIM_EGR_TG TIM_EGR_TG_Msk
+#define TIM_EGR_BG_Pos (7U)
+#define TIM_EGR_BG_Msk (0x1U << TIM_EGR_BG_Pos)
+#define TIM_EGR_BG TIM_EGR_BG_Msk
+
+// TIM CCMR1
+#define TIM_CCMR1_CC1S_Pos (0U)
+#define TIM_CCMR1_CC1S_Msk (0x3U << TIM_CCMR1_CC1S_Pos)
+#define TIM_CCMR1_CC1S TIM_CCMR1_CC1S_Msk
+#define TIM_CCMR1_CC1S_0 (0x1U << (TIM_CCMR1_CC1S_Pos + 0U))
+#define TIM_CCMR1_CC1S_1 (0x1U << (TIM_CCMR1_CC1S_Pos + 1U))
+#define TIM_CCMR1_OC1FE_Pos (2U)
+#define TIM_CCMR1_OC1FE_Msk (0x1U << TIM_CCMR1_OC1FE_Pos)
+#define TIM_CCMR1_OC1FE TIM_CCMR1_OC1FE_Msk
+#define TIM_CCMR1_OC1PE_Pos (3U)
+#define TIM_CCMR1_OC1PE_Msk (0x1U << TIM_CCMR1_OC1PE_Pos)
+#define TIM_CCMR1_OC1PE TIM_CCMR1_OC1PE_Msk
+#define TIM_CCMR1_OC1M_Pos (4U)
+#define TIM_CCMR1_OC1M_Msk (0x7U << TIM_CCMR1_OC1M_Pos)
+#define TIM_CCMR1_OC1M TIM_CCMR1_OC1M_Msk
+#define TIM_CCMR1_OC1M_0 (0x1U << (TIM_CCMR1_OC1M_Pos + 0U))
+#define TIM_CCMR1_OC1M_1 (0x1U << (TIM_CCMR1_OC1M_Pos + 1U))
+#define TIM_CCMR1_OC1M_2 (0x1U << (TIM_CCMR1_OC1M_Pos + 2U))
+#define TIM_CCMR1_OC1CE_Pos (7U)
+#define TIM_CCMR1_OC1CE_Msk (0x1U << TIM_CCMR1_OC1CE_Pos)
+#define TIM_CCMR1_OC1CE TIM_CCMR1_OC1CE_Msk
+#define TIM_CCMR1_CC2S_Pos (8U)
+#define TIM_CCMR1_CC2S_Msk (0x3U << TIM_CCMR1_CC2S_Pos)
+#define TIM_CCMR1_CC2S TIM_CCMR1_CC2S_Msk
+#define TIM_CCMR1_CC2S_0 (0x1U << (TIM_CCMR1_CC2S_Pos + 0U))
+#define TIM_CCMR1_CC2S_1 (0x1U << (TIM_CCMR1_CC2S_Pos + 1U))
+#define TIM_CCMR1_OC2FE_Pos (10U)
+#define TIM_CCMR1_OC2FE_Msk (0x1U << TIM_CCMR1_OC2FE_Pos)
+#define TIM_CCMR1_OC2FE TIM_CCMR1_OC2FE_Msk
+#define TIM_CCMR1_OC2PE_Pos (11U)
+#define TIM_CCMR1_OC2PE_Msk (0x1U << TIM_CCMR1_OC2PE_Pos)
+#define TIM_CCMR1_OC2PE TIM_CCMR1_OC2PE_Msk
+#define TIM_CCMR1_OC2M_Pos (12U)
+#define TIM_CCMR1_OC2M_Msk (0x7U << TIM_CCMR1_OC2M_Pos)
+#define TIM_CCMR1_OC2M TIM_CCMR1_OC2M_Msk
+#define TIM_CCMR1_OC2M_0 (0x1U << (TIM_CCMR1_OC2M_Pos + 0U))
+#define TIM_CCMR1_OC2M_1 (0x1U << (TIM_CCMR1_OC2M_Pos + 1U))
+#define TIM_CCMR1_OC2M_2 (0x1U << (TIM_CCMR1_OC2M_Pos + 2U))
+#define TIM_CCMR1_OC2CE_Pos (15U)
+#define TIM_CCMR1_OC2CE_Msk (0x1U << TIM_CCMR1_OC2CE_Pos)
+#define TIM_CCMR1_OC2CE TIM_CCMR1_OC2CE_Msk
+#define TIM_CCMR1_IC1PSC_Pos (2U)
+#define TIM_CCMR1_IC1PSC_Msk (0x3U << TIM_CCMR1_IC1PSC_Pos)
+#define TIM_CCMR1_IC1PSC TIM_CCMR1_IC1PSC_Msk
+#define TIM_CCMR1_IC1PSC_0 (0x1U << (TIM_CCMR1_IC1PSC_Pos + 0U))
+#define TIM_CCMR1_IC1PSC_1 (0x1U << (TIM_CCMR1_IC1PSC_Pos + 1U))
+#define TIM_CCMR1_IC1F_Pos (4U)
+#define TIM_CCMR1_IC1F_Msk (0xFU << TIM_CCMR1_IC1F_Pos)
+#define TIM_CCMR1_IC1F TIM_CCMR1_IC1F_Msk
+#define TIM_CCMR1_IC1F_0 (0x1U << (TIM_CCMR1_IC1F_Pos + 0U))
+#define TIM_CCMR1_IC1F_1 (0x1U << (TIM_CCMR1_IC1F_Pos + 1U))
+#define TIM_CCMR1_IC1F_2 (0x1U << (TIM_CCMR1_IC1F_Pos + 2U))
+#define TIM_CCMR1_IC1F_3 (0x1U << (TIM_CCMR1_IC1F_Pos + 3U))
+#define TIM_CCMR1_IC2PSC_Pos (10U)
+#define TIM_CCMR1_IC2PSC_Msk (0x3U << TIM_CCMR1_IC2PSC_Pos)
+#define TIM_CCMR1_IC2PSC TIM_CCMR1_IC2PSC_Msk
+#define TIM_CCMR1_IC2PSC_0 (0x1U << (TIM_CCMR1_IC2PSC_Pos + 0U))
+#define TIM_CCMR1_IC2PSC_1 (0x1U << (TIM_CCMR1_IC2PSC_Pos + 1U))
+#define TIM_CCMR1_IC2F_Pos (12U)
+#define TIM_CCMR1_IC2F_Msk (0xFU << TIM_CCMR1_IC2F_Pos)
+#define TIM_CCMR1_IC2F TIM_CCMR1_IC2F_Msk
+#define TIM_CCMR1_IC2F_0 (0x1U << (TIM_CCMR1_IC2F_Pos + 0U))
+#define TIM_CCMR1_IC2F_1 (0x1U << (TIM_CCMR1_IC2F_Pos + 1U))
+#define TIM_CCMR1_IC2F_2 (0x1U << (TIM_CCMR1_IC2F_Pos + 2U))
+#define TIM_CCMR1_IC2F_3 (0x1U << (TIM_CCMR1_IC2F_Pos + 3U))
+
+// TIM CCMR2
+#define TIM_CCMR2_CC3S_Pos (0U)
+#define TIM_CCMR2_CC3S_Msk (0x3U << TIM_CCMR2_CC3S_Pos)
+#define TIM_CCMR2_CC3S TIM_CCMR2_CC3S_Msk
+#define TIM_CCMR2_CC3S_0 (0x1U << (TIM_CCMR2_CC3S_Pos + 0U))
+#define TIM_CCMR2_CC3S_1 (0x1U << (TIM_CCMR2_CC3S_Pos + 1U))
+#define TIM_CCMR2_OC3FE_Pos (2U)
+#define TIM_CCMR2_OC3FE_Msk (0x1U << TIM_CCMR2_OC3FE_Pos)
+#define TIM_CCMR2_OC3FE TIM_CCMR2_OC3FE_Msk
+#define TIM_CCMR2_OC3PE_Pos (3U)
+#define TIM_CCMR2_OC3PE_Msk (0x1U << TIM_CCMR2_OC3PE_Pos)
+#define TIM_CCMR2_OC3PE TIM_CCMR2_OC3PE_Msk
+#define TIM_CCMR2_OC3M_Pos (4U)
+#define TIM_CCMR2_OC3M_Msk (0x7U << TIM_CCMR2_OC3M_Pos)
+#define TIM_CCMR2_OC3M TIM_CCMR2_OC3M_Msk
+#define TIM_CCMR2_OC3M_0 (0x1U << (TIM_CCMR2_OC3M_Pos + 0U))
+#define TIM_CCMR2_OC3M_1 (0x1U << (TIM_CCMR2_OC3M_Pos + 1U))
+#define TIM_CCMR2_OC3M_2 (0x1U << (TIM_CCMR2_OC3M_Pos + 2U))
+#define TIM_CCMR2_OC3CE_Pos (7U)
+#define TIM_CCMR2_OC3CE_Msk (0x1U << TIM_CCMR2_OC3CE_Pos)
+#define TIM_CCMR2_OC3CE TIM_CCMR2_OC3CE_Msk
+#define TIM_CCMR2_CC4S_Pos (8U)
+#define TIM_CCMR2_CC4S_Msk (0x3U << TIM_CCMR2_CC4S_Pos)
+#define TIM_CCMR2_CC4S TIM_CCMR2_CC4S_Msk
+#define TIM_CCMR2_CC4S_0 (0x1U << (TIM_CCMR2_CC4S_Pos + 0U))
+#define TIM_CCMR2_CC4S_1 (0x1U << (TIM_CCMR2_CC4S_Pos + 1U))
+#define TIM_CCMR2_OC4FE_Pos (10U)
+#define TIM_CCMR2_OC4FE_Msk (0x1U << TIM_CCMR2_OC4FE_Pos)
+#define TIM_CCMR2_OC4FE TIM_CCMR2_OC4FE_Msk
+#define TIM_CCMR2_OC4PE_Pos (11U)
+#define TIM_CCMR2_OC4PE_Msk (0x1U << TIM_CCMR2_OC4PE_Pos)
+#define TIM_CCMR2_OC4PE TIM_CCMR2_OC4PE_Msk
+#define TIM_CCMR2_OC4M_Pos (12U)
+#define TIM_CCMR2_OC4M_Msk (0x7U << TIM_CCMR2_OC4M_Pos)
+#define TIM_CCMR2_OC4M TIM_CCMR2_OC4M_Msk
+#define TIM_CCMR2_OC4M_0 (0x1U << (TIM_CCMR2_OC4M_Pos + 0U))
+#define TIM_CCMR2_OC4M_1 (0x1U << (TIM_CCMR2_OC4M_Pos + 1U))
+#define TIM_CCMR2_OC4M_2 (0x1U << (TIM_CCMR2_OC4M_Pos + 2U))
+#define TIM_CCMR2_OC4CE_Pos (15U)
+#define TIM_CCMR2_OC4CE_Msk (0x1U << TIM_CCMR2_OC4CE_Pos)
+#define TIM_CCMR2_OC4CE TIM_CCMR2_OC4CE_Msk
+#define TIM_CCMR2_IC3PSC_Pos (2U)
+#define TIM_CCMR2_IC3PSC_Msk (0x3U << TIM_CCMR2_IC3PSC_Pos)
+#define TIM_CCMR2_IC3PSC TIM_CCMR2_IC3PSC_Msk
+#define TIM_CCMR2_IC3PSC_0 (0x1U << (TIM_CCMR2_IC3PSC_Pos + 0U))
+#define TIM_CCMR2_IC3PSC_1 (0x1U << (TIM_CCMR2_IC3PSC_Pos + 1U))
+#define TIM_CCMR2_IC3F_Pos (4U)
+#define TIM_CCMR2_IC3F_Msk (0xFU << TIM_CCMR2_IC3F_Pos)
+#define TIM_CCMR2_IC3F TIM_CCMR2_IC3F_Msk
+#define TIM_CCMR2_IC3F_0 (0x1U << (TIM_CCMR2_IC3F_Pos + 0U))
+#define TIM_CCMR2_IC3F_1 (0x1U << (TIM_CCMR2_IC3F_Pos + 1U))
+#define TIM_CCMR2_IC3F_2 (0x1U << (TIM_CCMR2_IC3F_Pos + 2U))
+#define TIM_CCMR2_IC3F_3 (0x1U << (TIM_CCMR2_IC3F_Pos + 3U))
+#define TIM_CCMR2_IC4PSC_Pos (10U)
+#define TIM_CCMR2_IC4PSC_Msk (0x3U << TIM_CCMR2_IC4PSC_Pos)
+#define TIM_CCMR2_IC4PSC TIM_CCMR2_IC4PSC_Msk
+#define TIM_CCMR2_IC4PSC_0 (0x1U << (TIM_CCMR2_IC4PSC_Pos + 0U))
+#define TIM_CCMR2_IC4PSC_1 (0x1U << (TIM_CCMR2_IC4PSC_Pos + 1U))
+#define TIM_CCMR2_IC4F_Pos (12U)
+#define TIM_CCMR2_IC4F_Msk (0xFU << TIM_CCMR2_IC4F_Pos)
+#define TIM_CCMR2_IC4F TIM_CCMR2_IC4F_Msk
+#define TIM_CCMR2_IC4F_0 (0x1U << (TIM_CCMR2_IC4F_Pos + 0U))
+#define TIM_CCMR2_IC4F_1 (0x1U << (TIM_CCMR2_IC4F_Pos + 1U))
+#define TIM_CCMR2_IC4F_2 (0x1U << (TIM_CCMR2_IC4F_Pos + 2U))
+#define TIM_CCMR2_IC4F_3 (0x1U << (TIM_CCMR2_IC4F_Pos + 3U))
+
+// TIM CCER
+#define TIM_CCER_CC1E_Pos (0U)
+#define TIM_CCER_CC1E_Msk (0x1U << TIM_CCER_CC1E_Pos)
+#define TIM_CCER_CC1E TIM_CCER_CC1E_Msk
+#define TIM_CCER_CC1P_Pos (1U)
+#define TIM_CCER_CC1P_Msk (0x1U << TIM_CCER_CC1P_Pos)
+#define TIM_CCER_CC1P TIM_CCER_CC1P_Msk
+#define TIM_CCER_CC1NE_Pos (2U)
+#define TIM_CCER_CC1NE_Msk (0x1U << TIM_CCER_CC1NE_Pos)
+#define TIM_CCER_CC1NE TIM_CCER_CC1NE_Msk
+#define TIM_CCER_CC1NP_Pos (3U)
+#define TIM_CCER_CC1NP_Msk (0x1U << TIM_CCER_CC1NP_Pos)
+#define TIM_CCER_CC1NP TIM_CCER_CC1NP_Msk
+#define TIM_CCER_CC2E_Pos (4U)
+#define TIM_CCER_CC2E_Msk (0x1U << TIM_CCER_CC2E_Pos)
+#define TIM_CCER_CC2E TIM_CCER_CC2E_Msk
+#define TIM_CCER_CC2P_Pos (5U)
+#define TIM_CCER_CC2P_Msk (0x1U << TIM_CCER_CC2P_Pos)
+#define TIM_CCER_CC2P TIM_CCER_CC2P_Msk
+#define TIM_CCER_CC2NE_Pos (6U)
+#define TIM_CCER_CC2NE_Msk (0x1U << TIM_CCER_CC2NE_Pos)
+#define TIM_CCER_CC2NE TIM_CCER_CC2NE_Msk
+#define TIM_CCER_CC2NP_Pos (7U)
+#define TIM_CCER_CC2NP_Msk (0x1U << TIM_CCER_CC2NP_Pos)
+#define TIM_CCER_CC2NP TIM_CCER_CC2NP_Msk
+#define TIM_CCER_CC3E_Pos (8U)
+#define TIM_CCER_CC3E_Msk (0x1U << TIM_CCER_CC3E_Pos)
+#define TIM_CCER_CC3E TIM_CCER_CC3E_Msk
+#define TIM_CCER_CC3P_Pos (9U)
+#define TIM_CCER_CC3P_Msk (0x1U << TIM_CCER_CC3P_Pos)
+#define TIM_CCER_CC3P TIM_CCER_CC3P_Msk
+#define TIM_CCER_CC3NE_Pos (10U)
+#define TIM_CCER_CC3NE_Msk (0x1U << TIM_CCER_CC3NE_Pos)
+#define TIM_CCER_CC3NE TIM_CCER_CC3NE_Msk
+#define TIM_CCER_CC3NP_Pos (11U)
+#define TIM_CCER_CC3NP_Msk (0x1U << TIM_CCER_CC3NP_Pos)
+#define TIM_CCER_CC3NP TIM_CCER_CC3NP_Msk
+#define TIM_CCER_CC4E_Pos (12U)
+#define TIM_CCER_CC4E_Msk (0x1U << TIM_CCER_CC4E_Pos)
+#define TIM_CCER_CC4E TIM_CCER_CC4E_Msk
+#define TIM_CCER_CC4P_Pos (13U)
+#define TIM_CCER_CC4P_Msk (0x1U << TIM_CCER_CC4P_Pos)
+#define TIM_CCER_CC4P TIM_CCER_CC4P_Msk
+
+// TIM BDTR
+#define TIM_BDTR_DTG_Pos (0U)
+#define TIM_BDTR_DTG_Msk (0xFFU << TIM_BDTR_DTG_Pos)
+#define TIM_BDTR_DTG TIM_BDTR_DTG_Msk
+#define TIM_BDTR_DTG_0 (0x1U << (TIM_BDTR_DTG_Pos + 0U))
+#define TIM_BDTR_DTG_1 (0x1U << (TIM_BDTR_DTG_Pos + 1U))
+#define TIM_BDTR_DTG_2 (0x1U << (TIM_BDTR_DTG_Pos + 2U))
+#define TIM_BDTR_DTG_3 (0x1U << (TIM_BDTR_DTG_Pos + 3U))
+#define TIM_BDTR_DTG_4 (0x1U << (TIM_BDTR_DTG_Pos + 4U))
+#define TIM_BDTR_DTG_5 (0x1U << (TIM_BDTR_DTG_Pos + 5U))
+#define TIM_BDTR_DTG_6 (0x1U << (TIM_BDTR_DTG_Pos + 6U))
+#define TIM_BDTR_DTG_7 (0x1U << (TIM_BDTR_DTG_Pos + 7U))
+#define TIM_BDTR_LOCK_Pos (8U)
+#define TIM_BDTR_LOCK_Msk (0x3U << TIM_BDTR_LOCK_Pos)
+#define TIM_BDTR_LOCK TIM_BDTR_LOCK_Msk
+#define TIM_BDTR_LOCK_0 (0x1U << (TIM_BDTR_LOCK_Pos + 0U))
+#define TIM_BDTR_LOCK_1 (0x1U << (TIM_BDTR_LOCK_Pos + 1U))
+#define TIM_BDTR_OSSI_Pos (10U)
+#define TIM_BDTR_OSSI_Msk (0x1U << TIM_BDTR_OSSI_Pos)
+#define TIM_BDTR_OSSI TIM_BDTR_OSSI_Msk
+#define TIM_BDTR_OSSR_Pos (11U)
+#define TIM_BDTR_OSSR_Msk (0x1U << TIM_BDTR_OSSR_Pos)
+#define TIM_BDTR_OSSR TIM_BDTR_OSSR_Msk
+#define TIM_BDTR_BKE_Pos (12U)
+#define TIM_BDTR_BKE_Msk (0x1U << TIM_BDTR_BKE_Pos)
+#define TIM_BDTR_BKE TIM_BDTR_BKE_Msk
+#define TIM_BDTR_BKP_Pos (13U)
+#define TIM_BDTR_BKP_Msk (0x1U << TIM_BDTR_BKP_Pos)
+#define TIM_BDTR_BKP TIM_BDTR_BKP_Msk
+#define TIM_BDTR_AOE_Pos (14U)
+#define TIM_BDTR_AOE_Msk (0x1U << TIM_BDTR_AOE_Pos)
+#define TIM_BDTR_AOE TIM_BDTR_AOE_Msk
+#define TIM_BDTR_MOE_Pos (15U)
+#define TIM_BDTR_MOE_Msk (0x1U << TIM_BDTR_MOE_Pos)
+#define TIM_BDTR_MOE TIM_BDTR_MOE_Msk
+
+// TIM DCR
+#define TIM_DCR_DBA_Pos (0U)
+#define TIM_DCR_DBA_Msk (0x1FU << TIM_DCR_DBA_Pos)
+#define TIM_DCR_DBA TIM_DCR_DBA_Msk
+#define TIM_DCR_DBA_0 (0x1U << (TIM_DCR_DBA_Pos + 0U))
+#define TIM_DCR_DBA_1 (0x1U << (TIM_DCR_DBA_Pos + 1U))
+#define TIM_DCR_DBA_2 (0x1U << (TIM_DCR_DBA_Pos + 2U))
+#define TIM_DCR_DBA_3 (0x1U << (TIM_DCR_DBA_Pos + 3U))
+#define TIM_DCR_DBA_4 (0x1U << (TIM_DCR_DBA_Pos + 4U))
+#define TIM_DCR_DBL_Pos (8U)
+#define TIM_DCR_DBL_Msk (0x1FU << TIM_DCR_DBL_Pos)
+#define TIM_DCR_DBL TIM_DCR_DBL_Msk
+#define TIM_DCR_DBL_0 (0x1U << (TIM_DCR_DBL_Pos + 0U))
+#define TIM_DCR_DBL_1 (0x1U << (TIM_DCR_DBL_Pos + 1U))
+#define TIM_DCR_DBL_2 (0x1U << (TIM_DCR_DBL_Pos + 2U))
+#define TIM_DCR_DBL_3 (0x1U << (TIM_DCR_DBL_Pos + 3U))
+#define TIM_DCR_DBL_4 (0x1U << (TIM_DCR_DBL_Pos + 4U))
+
+// DMA CCR
+#define DMA_CCR_EN_Pos (0U)
+#define DMA_CCR_EN_Msk (0x1U << DMA_CCR_EN_Pos)
+#define DMA_CCR_EN DMA_CCR_EN_Msk
+#define DMA_CCR_TCIE_Pos (1U)
+#define DMA_CCR_TCIE_Msk (0x1U << DMA_CCR_TCIE_Pos)
+#define DMA_CCR_TCIE DMA_CCR_TCIE_Msk
+#define DMA_CCR_HTIE_Pos (2U)
+#define DMA_CCR_HTIE_Msk (0x1U << DMA_CCR_HTIE_Pos)
+#define DMA_CCR_HTIE DMA_CCR_HTIE_Msk
+#define DMA_CCR_TEIE_Pos (3U)
+#define DMA_CCR_TEIE_Msk (0x1U << DMA_CCR_TEIE_Pos)
+#define DMA_CCR_TEIE DMA_CCR_TEIE_Msk
+#define DMA_CCR_DIR_Pos (4U)
+#define DMA_CCR_DIR_Msk (0x1U << DMA_CCR_DIR_Pos)
+#define DMA_CCR_DIR DMA_CCR_DIR_Msk
+#define DMA_CCR_CIRC_Pos (5U)
+#define DMA_CCR_CIRC_Msk (0x1U << DMA_CCR_CIRC_Pos)
+#define DMA_CCR_CIRC DMA_CCR_CIRC_Msk
+#define DMA_CCR_PINC_Pos (6U)
+#define DMA_CCR_PINC_Msk (0x1U << DMA_CCR_PINC_Pos)
+#define DMA_CCR_PINC DMA_CCR_PINC_Msk
+#define DMA_CCR_MINC_Pos (7U)
+#define DMA_CCR_MINC_Msk (0x1U << DMA_CCR_MINC_Pos)
+#define DMA_CCR_MINC DMA_CCR_MINC_Msk
+#define DMA_CCR_PSIZE_Pos (8U)
+#define DMA_CCR_PSIZE_Msk (0x3U << DMA_CCR_PSIZE_Pos)
+#define DMA_CCR_PSIZE DMA_CCR_PSIZE_Msk
+#define DMA_CCR_PSIZE_0 (0x1U << (DMA_CCR_PSIZE_Pos + 0U))
+#define DMA_CCR_PSIZE_1 (0x1U << (DMA_CCR_PSIZE_Pos + 1U))
+#define DMA_CCR_MSIZE_Pos (10U)
+#define DMA_CCR_MSIZE_Msk (0x3U << DMA_CCR_MSIZE_Pos)
+#define DMA_CCR_MSIZE DMA_CCR_MSIZE_Msk
+#define DMA_CCR_MSIZE_0 (0x1U << (DMA_CCR_MSIZE_Pos + 0U))
+#define DMA_CCR_MSIZE_1 (0x1U << (DMA_CCR_MSIZE_Pos + 1U))
+#define DMA_CCR_PL_Pos (12U)
+#define DMA_CCR_PL_Msk (0x3U << DMA_CCR_PL_Pos)
+#define DMA_CCR_PL DMA_CCR_PL_Msk
+#define DMA_CCR_PL_0 (0x1U << (DMA_CCR_PL_Pos + 0U))
+#define DMA_CCR_PL_1 (0x1U << (DMA_CCR_PL_Pos + 1U))
+#define DMA_CCR_MEM2MEM_Pos (14U)
+#define DMA_CCR_MEM2MEM_Msk (0x1U << DMA_CCR_MEM2MEM_Pos)
+#define DMA_CCR_MEM2MEM DMA_CCR_MEM2MEM_Msk
+
+// I2C CR1
+#define I2C_CR1_PE_Pos (0U)
+#define I2C_CR1_PE_Msk (0x1U << I2C_CR1_PE_Pos)
+#define I2C_CR1_PE I2C_CR1_PE_Msk
+#define I2C_CR1_SMBUS_Pos (1U)
+#define I2C_CR1_SMBUS_Msk (0x1U << I2C_CR1_SMBUS_Pos)
+#define I2C_CR1_SMBUS I2C_CR1_SMBUS_Msk
+#define I2C_CR1_SMBTYPE_Pos (3U)
+#define I2C_CR1_SMBTYPE_Msk (0x1U << I2C_CR1_SMBTYPE_Pos)
+#define I2C_CR1_SMBTYPE I2C_CR1_SMBTYPE_Msk
+#define I2C_CR1_ENARP_Pos (4U)
+#define I2C_CR1_ENARP_Msk (0x1U << I2C_CR1_ENARP_Pos)
+#define I2C_CR1_ENARP I2C_CR1_ENARP_Msk
+#define I2C_CR1_ENPEC_Pos (5U)
+#define I2C_CR1_ENPEC_Msk (0x1U << I2C_CR1_ENPEC_Pos)
+#define I2C_CR1_ENPEC I2C_CR1_ENPEC_Msk
+#define I2C_CR1_ENGC_Pos (6U)
+#define I2C_CR1_ENGC_Msk (0x1U << I2C_CR1_ENGC_Pos)
+#define I2C_CR1_ENGC I2C_CR1_ENGC_Msk
+#define I2C_CR1_NOSTRETCH_Pos (7U)
+#define I2C_CR1_NOSTRETCH_Msk (0x1U << I2C_CR1_NOSTRETCH_Pos)
+#define I2C_CR1_NOSTRETCH I2C_CR1_NOSTRETCH_Msk
+#define I2C_CR1_START_Pos (8U)
+#define I2C_CR1_START_Msk (0x1U << I2C_CR1_START_Pos)
+#define I2C_CR1_START I2C_CR1_START_Msk
+#define I2C_CR1_STOP_Pos (9U)
+#define I2C_CR1_STOP_Msk (0x1U << I2C_CR1_STOP_Pos)
+#define I2C_CR1_STOP I2C_CR1_STOP_Msk
+#define I2C_CR1_ACK_Pos (10U)
+#define I2C_CR1_ACK_Msk (0x1U << I2C_CR1_ACK_Pos)
+#define I2C_CR1_ACK I2C_CR1_ACK_Msk
+#define I2C_CR1_POS_Pos (11U)
+#define I2C_CR1_POS_Msk (0x1U << I2C_CR1_POS_Pos)
+#define I2C_CR1_POS I2C_CR1_POS_Msk
+#define I2C_CR1_PEC_Pos (12U)
+#define I2C_CR1_PEC_Msk (0x1U << I2C_CR1_PEC_Pos)
+#define I2C_CR1_PEC I2C_CR1_PEC_Msk
+#define I2C_CR1_ALERT_Pos (13U)
+#define I2C_CR1_ALERT_Msk (0x1U << I2C_CR1_ALERT_Pos)
+#define I2C_CR1_ALERT I2C_CR1_ALERT_Msk
+#define I2C_CR1_SWRST_Pos (15U)
+#define I2C_CR1_SWRST_Msk (0x1U << I2C_CR1_SWRST_Pos)
+#define I2C_CR1_SWRST I2C_CR1_SWRST_Msk
+
+// I2C CR2
+#define I2C_CR2_FREQ_Pos (0U)
+#define I2C_CR2_FREQ_Msk (0x3FU << I2C_CR2_FREQ_Pos)
+#define I2C_CR2_FREQ I2C_CR2_FREQ_Msk
+#define I2C_CR2_FREQ_0 (0x1U << (I2C_CR2_FREQ_Pos + 0U))
+#define I2C_CR2_FREQ_1 (0x1U << (I2C_CR2_FREQ_Pos + 1U))
+#define I2C_CR2_FREQ_2 (0x1U << (I2C_CR2_FREQ_Pos + 2U))
+#define I2C_CR2_FREQ_3 (0x1U << (I2C_CR2_FREQ_Pos + 3U))
+#define I2C_CR2_FREQ_4 (0x1U << (I2C_CR2_FREQ_Pos + 4U))
+#define I2C_CR2_FREQ_5 (0x1U << (I2C_CR2_FREQ_Pos + 5U))
+#define I2C_CR2_ITERREN_Pos (8U)
+#define I2C_CR2_ITERREN_Msk (0x1U << I2C_CR2_ITERREN_Pos)
+#define I2C_CR2_ITERREN I2C_CR2_ITERREN_Msk
+#define I2C_CR2_ITEVTEN_Pos (9U)
+#define I2C_CR2_ITEVTEN_Msk (0x1U << I2C_CR2_ITEVTEN_Pos)
+#define I2C_CR2_ITEVTEN I2C_CR2_ITEVTEN_Msk
+#define I2C_CR2_ITBUFEN_Pos (10U)
+#define I2C_CR2_ITBUFEN_Msk (0x1U << I2C_CR2_ITBUFEN_Pos)
+#define I2C_CR2_ITBUFEN I2C_CR2_ITBUFEN_Msk
+#define I2C_CR2_DMAEN_Pos (11U)
+#define I2C_CR2_DMAEN_Msk (0x1U << I2C_CR2_DMAEN_Pos)
+#define I2C_CR2_DMAEN I2C_CR2_DMAEN_Msk
+#define I2C_CR2_LAST_Pos (12U)
+#define I2C_CR2_LAST_Msk (0x1U << I2C_CR2_LAST_Pos)
+#define I2C_CR2_LAST I2C_CR2_LAST_Msk
+
+// I2C SR1
+#define I2C_SR1_SB_Pos (0U)
+#define I2C_SR1_SB_Msk (0x1U << I2C_SR1_SB_Pos)
+#define I2C_SR1_SB I2C_SR1_SB_Msk
+#define I2C_SR1_ADDR_Pos (1U)
+#define I2C_SR1_ADDR_Msk (0x1U << I2C_SR1_ADDR_Pos)
+#define I2C_SR1_ADDR I2C_SR1_ADDR_Msk
+#define I2C_SR1_BTF_Pos (2U)
+#define I2C_SR1_BTF_Msk (0x1U << I2C_SR1_BTF_Pos)
+#define I2C_SR1_BTF I2C_SR1_BTF_Msk
+#define I2C_SR1_ADD10_Pos (3U)
+#define I2C_SR1_ADD10_Msk (0x1U << I2C_SR1_ADD10_Pos)
+#define I2C_SR1_ADD10 I2C_SR1_ADD10_Msk
+#define I2C_SR1_STOPF_Pos (4U)
+#define I2C_SR1_STOPF_Msk (0x1U << I2C_SR1_STOPF_Pos)
+#define I2C_SR1_STOPF I2C_SR1_STOPF_Msk
+#define I2C_SR1_RXNE_Pos (6U)
+#define I2C_SR1_RXNE_Msk (0x1U << I2C_SR1_RXNE_Pos)
+#define I2C_SR1_RXNE I2C_SR1_RXNE_Msk
+#define I2C_SR1_TXE_Pos (7U)
+#define I2C_SR1_TXE_Msk (0x1U << I2C_SR1_TXE_Pos)
+#define I2C_SR1_TXE I2C_SR1_TXE_Msk
+#define I2C_SR1_BERR_Pos (8U)
+#define I2C_SR1_BERR_Msk (0x1U << I2C_SR1_BERR_Pos)
+#define I2C_SR1_BERR I2C_SR1_BERR_Msk
+#define I2C_SR1_ARLO_Pos (9U)
+#define I2C_SR1_ARLO_Msk (0x1U << I2C_SR1_ARLO_Pos)
+#define I2C_SR1_ARLO I2C_SR1_ARLO_Msk
+#define I2C_SR1_AF_Pos (10U)
+#define I2C_SR1_AF_Msk (0x1U << I2C_SR1_AF_Pos)
+#define I2C_SR1_AF I2C_SR1_AF_Msk
+#define I2C_SR1_OVR_Pos (11U)
+#define I2C_SR1_OVR_Msk (0x1U << I2C_SR1_OVR_Pos)
+#define I2C_SR1_OVR I2C_SR1_OVR_Msk
+#define I2C_SR1_PECERR_Pos (12U)
+#define I2C_SR1_PECERR_Msk (0x1U << I2C_SR1_PECERR_Pos)
+#define I2C_SR1_PECERR I2C_SR1_PECERR_Msk
+#define I2C_SR1_TIMEOUT_Pos (14U)
+#define I2C_SR1_TIMEOUT_Msk (0x1U << I2C_SR1_TIMEOUT_Pos)
+#define I2C_SR1_TIMEOUT I2C_SR1_TIMEOUT_Msk
+#define I2C_SR1_SMBALERT_Pos (15U)
+#define I2C_SR1_SMBALERT_Msk (0x1U << I2C_SR1_SMBALERT_Pos)
+#define I2C_SR1_SMBALERT I2C_SR1_SMBALERT_Msk
+
+// I2C SR2
+#define I2C_SR2_MSL_Pos (0U)
+#define I2C_SR2_MSL_Msk (0x1U << I2C_SR2_MSL_Pos)
+#define I2C_SR2_MSL I2C_SR2_MSL_Msk
+#define I2C_SR2_BUSY_Pos (1U)
+#define I2C_SR2_BUSY_Msk (0x1U << I2C_SR2_BUSY_Pos)
+#define I2C_SR2_BUSY I2C_SR2_BUSY_Msk
+#define I2C_SR2_TRA_Pos (2U)
+#define I2C_SR2_TRA_Msk (0x1U << I2C_SR2_TRA_Pos)
+#define I2C_SR2_TRA I2C_SR2_TRA_Msk
+#define I2C_SR2_GENCALL_Pos (4U)
+#define I2C_SR2_GENCALL_Msk (0x1U << I2C_SR2_GENCALL_Pos)
+#define I2C_SR2_GENCALL I2C_SR2_GENCALL_Msk
+#define I2C_SR2_SMBDEFAULT_Pos (5U)
+#define I2C_SR2_SMBDEFAULT_Msk (0x1U << I2C_SR2_SMBDEFAULT_Pos)
+#define I2C_SR2_SMBDEFAULT I2C_SR2_SMBDEFAULT_Msk
+#define I2C_SR2_SMBHOST_Pos (6U)
+#define I2C_SR2_SMBHOST_Msk (0x1U << I2C_SR2_SMBHOST_Pos)
+#define I2C_SR2_SMBHOST I2C_SR2_SMBHOST_Msk
+#define I2C_SR2_DUALF_Pos (7U)
+#define I2C_SR2_DUALF_Msk (0x1U << I2C_SR2_DUALF_Pos)
+#define I2C_SR2_DUALF I2C_SR2_DUALF_Msk
+#define I2C_SR2_PEC_Pos (8U)
+#define I2C_SR2_PEC_Msk (0xFFU << I2C_SR2_PEC_Pos)
+#define I2C_SR2_PEC I2C_SR2_PEC_Msk
+#define I2C_SR2_PEC_0 (0x1U << (I2C_SR2_PEC_Pos + 0U))
+#define I2C_SR2_PEC_1 (0x1U << (I2C_SR2_PEC_Pos + 1U))
+#define I2C_SR2_PEC_2 (0x1U << (I2C_SR2_PEC_Pos + 2U))
+#define I2C_SR2_PEC_3 (0x1U << (I2C_SR2_PEC_Pos + 3U))
+#define I2C_SR2_PEC_4 (0x1U << (I2C_SR2_PEC_Pos + 4U))
+#define I2C_SR2_PEC_5 (0x1U << (I2C_SR2_PEC_Pos + 5U))
+#define I2C_SR2_PEC_6 (0x1U << (I2C_SR2_PEC_Pos + 6U))
+#define I2C_SR2_PEC_7 (0x1U << (I2C_SR2_PEC_Pos + 7U))
+
+// USART SR
+#define USART_SR_PE_Pos (0U)
+#define USART_SR_PE_Msk (0x1U << USART_SR_PE_Pos)
+#define USART_SR_PE USART_SR_PE_Msk
+#define USART_SR_FE_Pos (1U)
+#define USART_SR_FE_Msk (0x1U << USART_SR_FE_Pos)
+#define USART_SR_FE USART_SR_FE_Msk
+#define USART_SR_NE_Pos (2U)
+#define USART_SR_NE_Msk (0x1U << USART_SR_NE_Pos)
+#define USART_SR_NE USART_SR_NE_Msk
+#define USART_SR_ORE_Pos (3U)
+#define USART_SR_ORE_Msk (0x1U << USART_SR_ORE_Pos)
+#define USART_SR_ORE USART_SR_ORE_Msk
+#define USART_SR_IDLE_Pos (4U)
+#define USART_SR_IDLE_Msk (0x1U << USART_SR_IDLE_Pos)
+#define USART_SR_IDLE USART_SR_IDLE_Msk
+#define USART_SR_RXNE_Pos (5U)
+#define USART_SR_RXNE_Msk (0x1U << USART_SR_RXNE_Pos)
+#define USART_SR_RXNE USART_SR_RXNE_Msk
+#define USART_SR_TC_Pos (6U)
+#define USART_SR_TC_Msk (0x1U << USART_SR_TC_Pos)
+#define USART_SR_TC USART_SR_TC_Msk
+#define USART_SR_TXE_Pos (7U)
+#define USART_SR_TXE_Msk (0x1U << USART_SR_TXE_Pos)
+#define USART_SR_TXE USART_SR_TXE_Msk
+#define USART_SR_LBD_Pos (8U)
+#define USART_SR_LBD_Msk (0x1U << USART_SR_LBD_Pos)
+#define USART_SR_LBD USART_SR_LBD_Msk
+#define USART_SR_CTS_Pos (9U)
+#define USART_SR_CTS_Msk (0x1U << USART_SR_CTS_Pos)
+#define USART_SR_CTS USART_SR_CTS_Msk
+
+// USART CR1
+#define USART_CR1_SBK_Pos (0U)
+#define USART_CR1_SBK_Msk (0x1U << USART_CR1_SBK_Pos)
+#define USART_CR1_SBK USART_CR1_SBK_Msk
+#define USART_CR1_RWU_Pos (1U)
+#define USART_CR1_RWU_Msk (0x1U << USART_CR1_RWU_Pos)
+#define USART_CR1_RWU USART_CR1_RWU_Msk
+#define USART_CR1_RE_Pos (2U)
+#define USART_CR1_RE_Msk (0x1U << USART_CR1_RE_Pos)
+#define USART_CR1_RE USART_CR1_RE_Msk
+#define USART_CR1_TE_Pos (3U)
+#define USART_CR1_TE_Msk (0x1U << USART_CR1_TE_Pos)
+#define USART_CR1_TE USART_CR1_TE_Msk
+#define USART_CR1_IDLEIE_Pos (4U)
+#define USART_CR1_IDLEIE_Msk (0x1U << USART_CR1_IDLEIE_Pos)
+#define USART_CR1_IDLEIE USART_CR1_IDLEIE_Msk
+#define USART_CR1_RXNEIE_Pos (5U)
+#define USART_CR1_RXNEIE_Msk (0x1U << USART_CR1_RXNEIE_Pos)
+#define USART_CR1_RXNEIE USART_CR1_RXNEIE_Msk
+#define USART_CR1_TCIE_Pos (6U)
+#define USART_CR1_TCIE_Msk (0x1U << USART_CR1_TCIE_Pos)
+#define USART_CR1_TCIE USART_CR1_TCIE_Msk
+#define USART_CR1_TXEIE_Pos (7U)
+#define USART_CR1_TXEIE_Msk (0x1U << USART_CR1_TXEIE_Pos)
+#define USART_CR1_TXEIE USART_CR1_TXEIE_Msk
+#define USART_CR1_PEIE_Pos (8U)
+#define USART_CR1_PEIE_Msk (0x1U << USART_CR1_PEIE_Pos)
+#define USART_CR1_PEIE USART_CR1_PEIE_Msk
+#define USART_CR1_PS_Pos (9U)
+#define USART_CR1_PS_Msk (0x1U << USART_CR1_PS_Pos)
+#define USART_CR1_PS USART_CR1_PS_Msk
+#define USART_CR1_PCE_Pos (10U)
+#define USART_CR1_PCE_Msk (0x1U << USART_CR1_PCE_Pos)
+#define USART_CR1_PCE USART_CR1_PCE_Msk
+#define USART_CR1_WAKE_Pos (11U)
+#define USART_CR1_WAKE_Msk (0x1U << USART_CR1_WAKE_Pos)
+#define USART_CR1_WAKE USART_CR1_WAKE_Msk
+#define USART_CR1_M_Pos (12U)
+#define USART_CR1_M_Msk (0x1U << USART_CR1_M_Pos)
+#define USART_CR1_M USART_CR1_M_Msk
+#define USART_CR1_UE_Pos (13U)
+#define USART_CR1_UE_Msk (0x1U << USART_CR1_UE_Pos)
+#define USART_CR1_UE USART_CR1_UE_Msk
+
+// USART CR3
+#define USART_CR3_EIE_Pos (0U)
+#define USART_CR3_EIE_Msk (0x1U << USART_CR3_EIE_Pos)
+#define USART_CR3_EIE USART_CR3_EIE_Msk
+#define USART_CR3_IREN_Pos (1U)
+#define USART_CR3_IREN_Msk (0x1U << USART_CR3_IREN_Pos)
+#define USART_CR3_IREN USART_CR3_IREN_Msk
+#define USART_CR3_IRLP_Pos (2U)
+#define USART_CR3_IRLP_Msk (0x1U << USART_CR3_IRLP_Pos)
+#define USART_CR3_IRLP USART_CR3_IRLP_Msk
+#define USART_CR3_HDSEL_Pos (3U)
+#define USART_CR3_HDSEL_Msk (0x1U << USART_CR3_HDSEL_Pos)
+#define USART_CR3_HDSEL USART_CR3_HDSEL_Msk
+#define USART_CR3_NACK_Pos (4U)
+#define USART_CR3_NACK_Msk (0x1U << USART_CR3_NACK_Pos)
+#define USART_CR3_NACK USART_CR3_NACK_Msk
+#define USART_CR3_SCEN_Pos (5U)
+#define USART_CR3_SCEN_Msk (0x1U << USART_CR3_SCEN_Pos)
+#define USART_CR3_SCEN USART_CR3_SCEN_Msk
+#define USART_CR3_DMAR_Pos (6U)
+#define USART_CR3_DMAR_Msk (0x1U << USART_CR3_DMAR_Pos)
+#define USART_CR3_DMAR USART_CR3_DMAR_Msk
+#define USART_CR3_DMAT_Pos (7U)
+#define USART_CR3_DMAT_Msk (0x1U << USART_CR3_DMAT_Pos)
+#define USART_CR3_DMAT USART_CR3_DMAT_Msk
+#define USART_CR3_RTSE_Pos (8U)
+#define USART_CR3_RTSE_Msk (0x1U << USART_CR3_RTSE_Pos)
+#define USART_CR3_RTSE USART_CR3_RTSE_Msk
+#define USART_CR3_CTSE_Pos (9U)
+#define USART_CR3_CTSE_Msk (0x1U << USART_CR3_CTSE_Pos)
+#define USART_CR3_CTSE USART_CR3_CTSE_Msk
+#define USART_CR3_CTSIE_Pos (10U)
+#define USART_CR3_CTSIE_Msk (0x1U << USART_CR3_CTSIE_Pos)
+#define USART_CR3_CTSIE USART_CR3_CTSIE_Msk
+
+// RCC CR
+#define RCC_CR_HSION_Pos (0U)
+#define RCC_CR_HSION_Msk (0x1U << RCC_CR_HSION_Pos)
+#define RCC_CR_HSION RCC_CR_HSION_Msk
+#define RCC_CR_HSIRDY_Pos (1U)
+#define RCC_CR_HSIRDY_Msk (0x1U << RCC_CR_HSIRDY_Pos)
+#define RCC_CR_HSIRDY RCC_CR_HSIRDY_Msk
+#define RCC_CR_HSEON_Pos (16U)
+#define RCC_CR_HSEON_Msk (0x1U << RCC_CR_HSEON_Pos)
+#define RCC_CR_HSEON RCC_CR_HSEON_Msk
+#define RCC_CR_HSERDY_Pos (17U)
+#define RCC_CR_HSERDY_Msk (0x1U << RCC_CR_HSERDY_Pos)
+#define RCC_CR_HSERDY RCC_CR_HSERDY_Msk
+#define RCC_CR_PLLON_Pos (24U)
+#define RCC_CR_PLLON_Msk (0x1U << RCC_CR_PLLON_Pos)
+#define RCC_CR_PLLON RCC_CR_PLLON_Msk
+#define RCC_CR_PLLRDY_Pos (25U)
+#define RCC_CR_PLLRDY_Msk (0x1U << RCC_CR_PLLRDY_Pos)
+#define RCC_CR_PLLRDY RCC_CR_PLLRDY_Msk
+
+// RCC AHBENR
+#define RCC_AHBENR_DMA1EN_Pos (0U)
+#define RCC_AHBENR_DMA1EN_Msk (0x1U << RCC_AHBENR_DMA1EN_Pos)
+#define RCC_AHBENR_DMA1EN RCC_AHBENR_DMA1EN_Msk
+
+// RCC APB1ENR
+#define RCC_APB1ENR_TIM2EN_Pos (0U)
+#define RCC_APB1ENR_TIM2EN_Msk (0x1U << RCC_APB1ENR_TIM2EN_Pos)
+#define RCC_APB1ENR_TIM2EN RCC_APB1ENR_TIM2EN_Msk
+#define RCC_APB1ENR_TIM3EN_Pos (1U)
+#define RCC_APB1ENR_TIM3EN_Msk (0x1U << RCC_APB1ENR_TIM3EN_Pos)
+#define RCC_APB1ENR_TIM3EN RCC_APB1ENR_TIM3EN_Msk
+#define RCC_APB1ENR_TIM4EN_Pos (2U)
+#define RCC_APB1ENR_TIM4EN_Msk (0x1U << RCC_APB1ENR_TIM4EN_Pos)
+#define RCC_APB1ENR_TIM4EN RCC_APB1ENR_TIM4EN_Msk
+#define RCC_APB1ENR_USART2EN_Pos (17U)
+#define RCC_APB1ENR_USART2EN_Msk (0x1U << RCC_APB1ENR_USART2EN_Pos)
+#define RCC_APB1ENR_USART2EN RCC_APB1ENR_USART2EN_Msk
+#define RCC_APB1ENR_USART3EN_Pos (18U)
+#define RCC_APB1ENR_USART3EN_Msk (0x1U << RCC_APB1ENR_USART3EN_Pos)
+#define RCC_APB1ENR_USART3EN RCC_APB1ENR_USART3EN_Msk
+#define RCC_APB1ENR_I2C1EN_Pos (21U)
+#define RCC_APB1ENR_I2C1EN_Msk (0x1U << RCC_APB1ENR_I2C1EN_Pos)
+#define RCC_APB1ENR_I2C1EN RCC_APB1ENR_I2C1EN_Msk
+#define RCC_APB1ENR_I2C2EN_Pos (22U)
+#define RCC_APB1ENR_I2C2EN_Msk (0x1U << RCC_APB1ENR_I2C2EN_Pos)
+#define RCC_APB1ENR_I2C2EN RCC_APB1ENR_I2C2EN_Msk
+
+// RCC APB2ENR
+#define RCC_APB2ENR_AFIOEN_Pos (0U)
+#define RCC_APB2ENR_AFIOEN_Msk (0x1U << RCC_APB2ENR_AFIOEN_Pos)
+#define RCC_APB2ENR_AFIOEN RCC_APB2ENR_AFIOEN_Msk
+#define RCC_APB2ENR_IOPAEN_Pos (2U)
+#define RCC_APB2ENR_IOPAEN_Msk (0x1U << RCC_APB2ENR_IOPAEN_Pos)
+#define RCC_APB2ENR_IOPAEN RCC_APB2ENR_IOPAEN_Msk
+#define RCC_APB2ENR_IOPBEN_Pos (3U)
+#define RCC_APB2ENR_IOPBEN_Msk (0x1U << RCC_APB2ENR_IOPBEN_Pos)
+#define RCC_APB2ENR_IOPBEN RCC_APB2ENR_IOPBEN_Msk
+#define RCC_APB2ENR_IOPCEN_Pos (4U)
+#define RCC_APB2ENR_IOPCEN_Msk (0x1U << RCC_APB2ENR_IOPCEN_Pos)
+#define RCC_APB2ENR_IOPCEN RCC_APB2ENR_IOPCEN_Msk
+#define RCC_APB2ENR_TIM1EN_Pos (11U)
+#define RCC_APB2ENR_TIM1EN_Msk (0x1U << RCC_APB2ENR_TIM1EN_Pos)
+#define RCC_APB2ENR_TIM1EN RCC_APB2ENR_TIM1EN_Msk
+#define RCC_APB2ENR_USART1EN_Pos (14U)
+#define RCC_APB2ENR_USART1EN_Msk (0x1U << RCC_APB2ENR_USART1EN_Pos)
+#define RCC_APB2ENR_USART1EN RCC_APB2ENR_USART1EN_Msk
+
+// AFIO MAPR
+#define AFIO_MAPR_SPI1_REMAP_Pos (0U)
+#define AFIO_MAPR_SPI1_REMAP_Msk (0x1U << AFIO_MAPR_SPI1_REMAP_Pos)
+#define AFIO_MAPR_SPI1_REMAP AFIO_MAPR_SPI1_REMAP_Msk
+#define AFIO_MAPR_I2C1_REMAP_Pos (1U)
+#define AFIO_MAPR_I2C1_REMAP_Msk (0x1U << AFIO_MAPR_I2C1_REMAP_Pos)
+#define AFIO_MAPR_I2C1_REMAP AFIO_MAPR_I2C1_REMAP_Msk
+#define AFIO_MAPR_USART1_REMAP_Pos (2U)
+#define AFIO_MAPR_USART1_REMAP_Msk (0x1U << AFIO_MAPR_USART1_REMAP_Pos)
+#define AFIO_MAPR_USART1_REMAP AFIO_MAPR_USART1_REMAP_Msk
+#define AFIO_MAPR_USART2_REMAP_Pos (3U)
+#define AFIO_MAPR_USART2_REMAP_Msk (0x1U << AFIO_MAPR_USART2_REMAP_Pos)
+#define AFIO_MAPR_USART2_REMAP AFIO_MAPR_USART2_REMAP_Msk
+#define AFIO_MAPR_SWJ_CFG_Pos (24U)
+#define AFIO_MAPR_SWJ_CFG_Msk (0x7U << AFIO_MAPR_SWJ_CFG_Pos)
+#define AFIO_MAPR_SWJ_CFG AFIO_MAPR_SWJ_CFG_Msk
+#define AFIO_MAPR_SWJ_CFG_0 (0x1U << (AFIO_MAPR_SWJ_CFG_Pos + 0U))
+#define AFIO_MAPR_SWJ_CFG_1 (0x1U << (AFIO_MAPR_SWJ_CFG_Pos + 1U))
+#define AFIO_MAPR_SWJ_CFG_2 (0x1U << (AFIO_MAPR_SWJ_CFG_Pos + 2U))
+
+// AFIO EXTICR4
+#define AFIO_EXTICR4_EXTI12_Pos (0U)
+#define AFIO_EXTICR4_EXTI12_Msk (0xFU << AFIO_EXTICR4_EXTI12_Pos)
+#define AFIO_EXTICR4_EXTI12 AFIO_EXTICR4_EXTI12_Msk
+#define AFIO_EXTICR4_EXTI12_PB (0x00000001U)
+
+// EXTI IMR, FTSR, SWIER and PR
+#define EXTI_IMR_MR12_Pos (12U)
+#define EXTI_IMR_MR12_Msk (0x1U << EXTI_IMR_MR12_Pos)
+#define EXTI_IMR_MR12 EXTI_IMR_MR12_Msk
+#define EXTI_FTSR_TR12_Pos (12U)
+#define EXTI_FTSR_TR12_Msk (0x1U << EXTI_FTSR_TR12_Pos)
+#define EXTI_FTSR_TR12 EXTI_FTSR_TR12_Msk
+#define EXTI_SWIER_SWIER12_Pos (12U)
+#define EXTI_SWIER_SWIER12_Msk (0x1U << EXTI_SWIER_SWIER12_Pos)
+#define EXTI_SWIER_SWIER12 EXTI_SWIER_SWIER12_Msk
+#define EXTI_PR_PR12_Pos (12U)
+#define EXTI_PR_PR12_Msk (0x1U << EXTI_PR_PR12_Pos)
+#define EXTI_PR_PR12 EXTI_PR_PR12_Msk
+
+// SysTick CTRL
+#define SysTick_CTRL_ENABLE_Pos (0U)
+#define SysTick_CTRL_ENABLE_Msk (0x1U << SysTick_CTRL_ENABLE_Pos)
+#define SysTick_CTRL_ENABLE SysTick_CTRL_ENABLE_Msk
+#define SysTick_CTRL_TICKINT_Pos (1U)
+#define SysTick_CTRL_TICKINT_Msk (0x1U << SysTick_CTRL_TICKINT_Pos)
+#define SysTick_CTRL_TICKINT SysTick_CTRL_TICKINT_Msk
+#define SysTick_CTRL_CLKSOURCE_Pos (2U)
+#define SysTick_CTRL_CLKSOURCE_Msk (0x1U << SysTick_CTRL_CLKSOURCE_Pos)
+#define SysTick_CTRL_CLKSOURCE SysTick_CTRL_CLKSOURCE_Msk
+#define SysTick_CTRL_COUNTFLAG_Pos (16U)
+#define SysTick_CTRL_COUNTFLAG_Msk (0x1U << SysTick_CTRL_COUNTFLAG_Pos)
+#define SysTick_CTRL_COUNTFLAG SysTick_CTRL_COUNTFLAG_Msk
+
+// DMA ISR
+#define DMA_ISR_GIF1_Pos (0U)
+#define DMA_ISR_GIF1_Msk (0x1U << DMA_ISR_GIF1_Pos)
+#define DMA_ISR_GIF1 DMA_ISR_GIF1_Msk
+#define DMA_ISR_TCIF1_Pos (1U)
+#define DMA_ISR_TCIF1_Msk (0x1U << DMA_ISR_TCIF1_Pos)
+#define DMA_ISR_TCIF1 DMA_ISR_TCIF1_Msk
+#define DMA_ISR_HTIF1_Pos (2U)
+#define DMA_ISR_HTIF1_Msk (0x1U << DMA_ISR_HTIF1_Pos)
+#define DMA_ISR_HTIF1 DMA_ISR_HTIF1_Msk
+#define DMA_ISR_TEIF1_Pos (3U)
+#define DMA_ISR_TEIF1_Msk (0x1U << DMA_ISR_TEIF1_Pos)
+#define DMA_ISR_TEIF1 DMA_ISR_TEIF1_Msk
+#define DMA_ISR_GIF2_Pos (4U)
+#define DMA_ISR_GIF2_Msk (0x1U << DMA_ISR_GIF2_Pos)
+#define DMA_ISR_GIF2 DMA_ISR_GIF2_Msk
+#define DMA_ISR_TCIF2_Pos (5U)
+#define DMA_ISR_TCIF2_Msk (0x1U << DMA_ISR_TCIF2_Pos)
+#define DMA_ISR_TCIF2 DMA_ISR_TCIF2_Msk
+#define DMA_ISR_HTIF2_Pos (6U)
+#define DMA_ISR_HTIF2_Msk (0x1U << DMA_ISR_HTIF2_Pos)
+#define DMA_ISR_HTIF2 DMA_ISR_HTIF2_Msk
+#define DMA_ISR_TEIF2_Pos (7U)
+#define DMA_ISR_TEIF2_Msk (0x1U << DMA_ISR_TEIF2_Pos)
+#define DMA_ISR_TEIF2 DMA_ISR_TEIF2_Msk
+#define DMA_ISR_GIF3_Pos (8U)
+#define DMA_ISR_GIF3_Msk (0x1U << DMA_ISR_GIF3_Pos)
+#define DMA_ISR_GIF3 DMA_ISR_GIF3_Msk
+#define DMA_ISR_TCIF3_Pos (9U)
+#define DMA_ISR_TCIF3_Msk (0x1U << DMA_ISR_TCIF3_Pos)
+#define DMA_ISR_TCIF3 DMA_ISR_TCIF3_Msk
+#define DMA_ISR_HTIF3_Pos (10U)
+#define DMA_ISR_HTIF3_Msk (0x1U << DMA_ISR_HTIF3_Pos)
+#define DMA_ISR_HTIF3 DMA_ISR_HTIF3_Msk
+#define DMA_ISR_TEIF3_Pos (11U)
+#define DMA_ISR_TEIF3_Msk (0x1U << DMA_ISR_TEIF3_Pos)
+#define DMA_ISR_TEIF3 DMA_ISR_TEIF3_Msk
+#define DMA_ISR_GIF4_Pos (12U)
+#define DMA_ISR_GIF4_Msk (0x1U << DMA_ISR_GIF4_Pos)
+#define DMA_ISR_GIF4 DMA_ISR_GIF4_Msk
+#define DMA_ISR_TCIF4_Pos (13U)
+#define DMA_ISR_TCIF4_Msk (0x1U << DMA_ISR_TCIF4_Pos)
+#define DMA_ISR_TCIF4 DMA_ISR_TCIF4_Msk
+#define DMA_ISR_HTIF4_Pos (14U)
+#define DMA_ISR_HTIF4_Msk (0x1U << DMA_ISR_HTIF4_Pos)
+#define DMA_ISR_HTIF4 DMA_ISR_HTIF4_Msk
+#define DMA_ISR_TEIF4_Pos (15U)
+#define DMA_ISR_TEIF4_Msk (0x1U << DMA_ISR_TEIF4_Pos)
+#define DMA_ISR_TEIF4 DMA_ISR_TEIF4_Msk
+#define DMA_ISR_GIF5_Pos (16U)
+#define DMA_ISR_GIF5_Msk (0x1U << DMA_ISR_GIF5_Pos)
+#define DMA_ISR_GIF5 DMA_ISR_GIF5_Msk
+#define DMA_ISR_TCIF5_Pos (17U)
+#define DMA_ISR_TCIF5_Msk (0x1U << DMA_ISR_TCIF5_Pos)
+#define DMA_ISR_TCIF5 DMA_ISR_TCIF5_Msk
+#define DMA_ISR_HTIF5_Pos (18U)
+#define DMA_ISR_HTIF5_Msk (0x1U << DMA_ISR_HTIF5_Pos)
+#define DMA_ISR_HTIF5 DMA_ISR_HTIF5_Msk
+#define DMA_ISR_TEIF5_Pos (19U)
+#define DMA_ISR_TEIF5_Msk (0x1U << DMA_ISR_TEIF5_Pos)
+#define DMA_ISR_TEIF5 DMA_ISR_TEIF5_Msk
+#define DMA_ISR_GIF6_Pos (20U)
+#define DMA_ISR_GIF6_Msk (0x1U << DMA_ISR_GIF6_Pos)
+#define DMA_ISR_GIF6 DMA_ISR_GIF6_Msk
+#define DMA_ISR_TCIF6_Pos (21U)
+#define DMA_ISR_TCIF6_Msk (0x1U << DMA_ISR_TCIF6_Pos)
+#define DMA_ISR_TCIF6 DMA_ISR_TCIF6_Msk
+#define DMA_ISR_HTIF6_Pos (22U)
+#define DMA_ISR_HTIF6_Msk (0x1U << DMA_ISR_HTIF6_Pos)
+#define DMA_ISR_HTIF6 DMA_ISR_HTIF6_Msk
+#define DMA_ISR_TEIF6_Pos (23U)
+#define DMA_ISR_TEIF6_Msk (0x1U << DMA_ISR_TEIF6_Pos)
+#define DMA_ISR_TEIF6 DMA_ISR_TEIF6_Msk
+#define DMA_ISR_GIF7_Pos (24U)
+#define DMA_ISR_GIF7_Msk (0x1U << DMA_ISR_GIF7_Pos)
+#define DMA_ISR_GIF7 DMA_ISR_GIF7_Msk
+#define DMA_ISR_TCIF7_Pos (25U)
+#define DMA_ISR_TCIF7_Msk (0x1U << DMA_ISR_TCIF7_Pos)
+#define DMA_ISR_TCIF7 DMA_ISR_TCIF7_Msk
+#define DMA_ISR_HTIF7_Pos (26U)
+#define DMA_ISR_HTIF7_Msk (0x1U << DMA_ISR_HTIF7_Pos)
+#define DMA_ISR_HTIF7 DMA_ISR_HTIF7_Msk
+#define DMA_ISR_TEIF7_Pos (27U)
+#define DMA_ISR_TEIF7_Msk (0x1U << DMA_ISR_TEIF7_Pos)
+#define DMA_ISR_TEIF7 DMA_ISR_TEIF7_Msk
+
+// DMA IFCR
+#define DMA_IFCR_CGIF1_Pos (0U)
+#define DMA_IFCR_CGIF1_Msk (0x1U << DMA_IFCR_CGIF1_Pos)
+#define DMA_IFCR_CGIF1 DMA_IFCR_CGIF1_Msk
+#define DMA_IFCR_CTCIF1_Pos (1U)
+#define DMA_IFCR_CTCIF1_Msk (0x1U << DMA_IFCR_CTCIF1_Pos)
+#define DMA_IFCR_CTCIF1 DMA_IFCR_CTCIF1_Msk
+#define DMA_IFCR_CHTIF1_Pos (2U)
+#define DMA_IFCR_CHTIF1_Msk (0x1U << DMA_IFCR_CHTIF1_Pos)
+#define DMA_IFCR_CHTIF1 DMA_IFCR_CHTIF1_Msk
+#define DMA_IFCR_CTEIF1_Pos (3U)
+#define DMA_IFCR_CTEIF1_Msk (0x1U << DMA_IFCR_CTEIF1_Pos)
+#define DMA_IFCR_CTEIF1 DMA_IFCR_CTEIF1_Msk
+#define DMA_IFCR_CGIF2_Pos (4U)
+#define DMA_IFCR_CGIF2_Msk (0x1U << DMA_IFCR_CGIF2_Pos)
+#define DMA_IFCR_CGIF2 DMA_IFCR_CGIF2_Msk
+#define DMA_IFCR_CTCIF2_Pos (5U)
+#define DMA_IFCR_CTCIF2_Msk (0x1U << DMA_IFCR_CTCIF2_Pos)
+#define DMA_IFCR_CTCIF2 DMA_IFCR_CTCIF2_Msk
+#define DMA_IFCR_CHTIF2_Pos (6U)
+#define DMA_IFCR_CHTIF2_Msk (0x1U << DMA_IFCR_CHTIF2_Pos)
+#define DMA_IFCR_CHTIF2 DMA_IFCR_CHTIF2_Msk
+#define DMA_IFCR_CTEIF2_Pos (7U)
+#define DMA_IFCR_CTEIF2_Msk (0x1U << DMA_IFCR_CTEIF2_Pos)
+#define DMA_IFCR_CTEIF2 DMA_IFCR_CTEIF2_Msk
+#define DMA_IFCR_CGIF3_Pos (8U)
+#define DMA_IFCR_CGIF3_Msk (0x1U << DMA_IFCR_CGIF3_Pos)
+#define DMA_IFCR_CGIF3 DMA_IFCR_CGIF3_Msk
+#define DMA_IFCR_CTCIF3_Pos (9U)
+#define DMA_IFCR_CTCIF3_Msk (0x1U << DMA_IFCR_CTCIF3_Pos)
+#define DMA_IFCR_CTCIF3 DMA_IFCR_CTCIF3_Msk
+#define DMA_IFCR_CHTIF3_Pos (10U)
+#define DMA_IFCR_CHTIF3_Msk (0x1U << DMA_IFCR_CHTIF3_Pos)
+#define DMA_IFCR_CHTIF3 DMA_IFCR_CHTIF3_Msk
+#define DMA_IFCR_CTEIF3_Pos (11U)
+#define DMA_IFCR_CTEIF3_Msk (0x1U << DMA_IFCR_CTEIF3_Pos)
+#define DMA_IFCR_CTEIF3 DMA_IFCR_CTEIF3_Msk
+#define DMA_IFCR_CGIF4_Pos (12U)
+#define DMA_IFCR_CGIF4_Msk (0x1U << DMA_IFCR_CGIF4_Pos)
+#define DMA_IFCR_CGIF4 DMA_IFCR_CGIF4_Msk
+#define DMA_IFCR_CTCIF4_Pos (13U)
+#define DMA_IFCR_CTCIF4_Msk (0x1U << DMA_IFCR_CTCIF4_Pos)
+#define DMA_IFCR_CTCIF4 DMA_IFCR_CTCIF4_Msk
+#define DMA_IFCR_CHTIF4_Pos (14U)
+#define DMA_IFCR_CHTIF4_Msk (0x1U << DMA_IFCR_CHTIF4_Pos)
+#define DMA_IFCR_CHTIF4 DMA_IFCR_CHTIF4_Msk
+#define DMA_IFCR_CTEIF4_Pos (15U)
+#define DMA_IFCR_CTEIF4_Msk (0x1U << DMA_IFCR_CTEIF4_Pos)
+#define DMA_IFCR_CTEIF4 DMA_IFCR_CTEIF4_Msk
+#define DMA_IFCR_CGIF5_Pos (16U)
+#define DMA_IFCR_CGIF5_Msk (0x1U << DMA_IFCR_CGIF5_Pos)
+#define DMA_IFCR_CGIF5 DMA_IFCR_CGIF5_Msk
+#define DMA_IFCR_CTCIF5_Pos (17U)
+#define DMA_IFCR_CTCIF5_Msk (0x1U << DMA_IFCR_CTCIF5_Pos)
+#define DMA_IFCR_CTCIF5 DMA_IFCR_CTCIF5_Msk
+#define DMA_IFCR_CHTIF5_Pos (18U)
+#define DMA_IFCR_CHTIF5_Msk (0x1U << DMA_IFCR_CHTIF5_Pos)
+#define DMA_IFCR_CHTIF5 DMA_IFCR_CHTIF5_Msk
+#define DMA_IFCR_CTEIF5_Pos (19U)
+#define DMA_IFCR_CTEIF5_Msk (0x1U << DMA_IFCR_CTEIF5_Pos)
+#define DMA_IFCR_CTEIF5 DMA_IFCR_CTEIF5_Msk
+#define DMA_IFCR_CGIF6_Pos (20U)
+#define DMA_IFCR_CGIF6_Msk (0x1U << DMA_IFCR_CGIF6_Pos)
+#define DMA_IFCR_CGIF6 DMA_IFCR_CGIF6_Msk
+#define DMA_IFCR_CTCIF6_Pos (21U)
+#define DMA_IFCR_CTCIF6_Msk (0x1U << DMA_IFCR_CTCIF6_Pos)
+#define DMA_IFCR_CTCIF6 DMA_IFCR_CTCIF6_Msk
+#define DMA_IFCR_CHTIF6_Pos (22U)
+#define DMA_IFCR_CHTIF6_Msk (0x1U << DMA_IFCR_CHTIF6_Pos)
+#define DMA_IFCR_CHTIF6 DMA_IFCR_CHTIF6_Msk
+#define DMA_IFCR_CTEIF6_Pos (23U)
+#define DMA_IFCR_CTEIF6_Msk (0x1U << DMA_IFCR_CTEIF6_Pos)
+#define DMA_IFCR_CTEIF6 DMA_IFCR_CTEIF6_Msk
+#define DMA_IFCR_CGIF7_Pos (24U)
+#define DMA_IFCR_CGIF7_Msk (0x1U << DMA_IFCR_CGIF7_Pos)
+#define DMA_IFCR_CGIF7 DMA_IFCR_CGIF7_Msk
+#define DMA_IFCR_CTCIF7_Pos (25U)
+#define DMA_IFCR_CTCIF7_Msk (0x1U << DMA_IFCR_CTCIF7_Pos)
+#define DMA_IFCR_CTCIF7 DMA_IFCR_CTCIF7_Msk
+#define DMA_IFCR_CHTIF7_Pos (26U)
+#define DMA_IFCR_CHTIF7_Msk (0x1U << DMA_IFCR_CHTIF7_Pos)
+#define DMA_IFCR_CHTIF7 DMA_IFCR_CHTIF7_Msk
+#define DMA_IFCR_CTEIF7_Pos (27U)
+#define DMA_IFCR_CTEIF7_Msk (0x1U << DMA_IFCR_CTEIF7_Pos)
+#define DMA_IFCR_CTEIF7 DMA_IFCR_CTEIF7_Msk
+
+// GPIO CRL
+#define GPIO_CRL_MODE0_Pos (0U)
+#define GPIO_CRL_MODE0_Msk (0x3U << GPIO_CRL_MODE0_Pos)
+#define GPIO_CRL_MODE0 GPIO_CRL_MODE0_Msk
+#define GPIO_CRL_MODE0_0 (0x1U << (GPIO_CRL_MODE0_Pos + 0U))
+#define GPIO_CRL_MODE0_1 (0x1U << (GPIO_CRL_MODE0_Pos + 1U))
+#define GPIO_CRL_CNF0_Pos (2U)
+#define GPIO_CRL_CNF0_Msk (0x3U << GPIO_CRL_CNF0_Pos)
+#define GPIO_CRL_CNF0 GPIO_CRL_CNF0_Msk
+#define GPIO_CRL_CNF0_0 (0x1U << (GPIO_CRL_CNF0_Pos + 0U))
+#define GPIO_CRL_CNF0_1 (0x1U << (GPIO_CRL_CNF0_Pos + 1U))
+#define GPIO_CRL_MODE1_Pos (4U)
+#define GPIO_CRL_MODE1_Msk (0x3U << GPIO_CRL_MODE1_Pos)
+#define GPIO_CRL_MODE1 GPIO_CRL_MODE1_Msk
+#define GPIO_CRL_MODE1_0 (0x1U << (GPIO_CRL_MODE1_Pos + 0U))
+#define GPIO_CRL_MODE1_1 (0x1U << (GPIO_CRL_MODE1_Pos + 1U))
+#define GPIO_CRL_CNF1_Pos (6U)
+#define GPIO_CRL_CNF1_Msk (0x3U << GPIO_CRL_CNF1_Pos)
+#define GPIO_CRL_CNF1 GPIO_CRL_CNF1_Msk
+#define GPIO_CRL_CNF1_0 (0x1U << (GPIO_CRL_CNF1_Pos + 0U))
+#define GPIO_CRL_CNF1_1 (0x1U << (GPIO_CRL_CNF1_Pos + 1U))
+#define GPIO_CRL_MODE2_Pos (8U)
+#define GPIO_CRL_MODE2_Msk (0x3U << GPIO_CRL_MODE2_Pos)
+#define GPIO_CRL_MODE2 GPIO_CRL_MODE2_Msk
+#define GPIO_CRL_MODE2_0 (0x1U << (GPIO_CRL_MODE2_Pos + 0U))
+#define GPIO_CRL_MODE2_1 (0x1U << (GPIO_CRL_MODE2_Pos + 1U))
+#define GPIO_CRL_CNF2_Pos (10U)
+#define GPIO_CRL_CNF2_Msk (0x3U << GPIO_CRL_CNF2_Pos)
+#define GPIO_CRL_CNF2 GPIO_CRL_CNF2_Msk
+#define GPIO_CRL_CNF2_0 (0x1U << (GPIO_CRL_CNF2_Pos + 0U))
+#define GPIO_CRL_CNF2_1 (0x1U << (GPIO_CRL_CNF2_Pos + 1U))
+#define GPIO_CRL_MODE3_Pos (12U)
+#define GPIO_CRL_MODE3_Msk (0x3U << GPIO_CRL_MODE3_Pos)
+#define GPIO_CRL_MODE3 GPIO_CRL_MODE3_Msk
+#define GPIO_CRL_MODE3_0 (0x1U << (GPIO_CRL_MODE3_Pos + 0U))
+#define GPIO_CRL_MODE3_1 (0x1U << (GPIO_CRL_MODE3_Pos + 1U))
+#define GPIO_CRL_CNF3_Pos (14U)
+#define GPIO_CRL_CNF3_Msk (0x3U << GPIO_CRL_CNF3_Pos)
+#define GPIO_CRL_CNF3 GPIO_CRL_CNF3_Msk
+#define GPIO_CRL_CNF3_0 (0x1U << (GPIO_CRL_CNF3_Pos + 0U))
+#define GPIO_CRL_CNF3_1 (0x1U << (GPIO_CRL_CNF3_Pos + 1U))
+#define GPIO_CRL_MODE4_Pos (16U)
+#define GPIO_CRL_MODE4_Msk (0x3U << GPIO_CRL_MODE4_Pos)
+#define GPIO_CRL_MODE4 GPIO_CRL_MODE4_Msk
+#define GPIO_CRL_MODE4_0 (0x1U << (GPIO_CRL_MODE4_Pos + 0U))
+#define GPIO_CRL_MODE4_1 (0x1U << (GPIO_CRL_MODE4_Pos + 1U))
+#define GPIO_CRL_CNF4_Pos (18U)
+#define GPIO_CRL_CNF4_Msk (0x3U << GPIO_CRL_CNF4_Pos)
+#define GPIO_CRL_CNF4 GPIO_CRL_CNF4_Msk
+#define GPIO_CRL_CNF4_0 (0x1U << (GPIO_CRL_CNF4_Pos + 0U))
+#define GPIO_CRL_CNF4_1 (0x1U << (GPIO_CRL_CNF4_Pos + 1U))
+#define GPIO_CRL_MODE5_Pos (20U)
+#define GPIO_CRL_MODE5_Msk (0x3U << GPIO_CRL_MODE5_Pos)
+#define GPIO_CRL_MODE5 GPIO_CRL_MODE5_Msk
+#define GPIO_CRL_MODE5_0 (0x1U << (GPIO_CRL_MODE5_Pos + 0U))
+#define GPIO_CRL_MODE5_1 (0x1U << (GPIO_CRL_MODE5_Pos + 1U))
+#define GPIO_CRL_CNF5_Pos (22U)
+#define GPIO_CRL_CNF5_Msk (0x3U << GPIO_CRL_CNF5_Pos)
+#define GPIO_CRL_CNF5 GPIO_CRL_CNF5_Msk
+#define GPIO_CRL_CNF5_0 (0x1U << (GPIO_CRL_CNF5_Pos + 0U))
+#define GPIO_CRL_CNF5_1 (0x1U << (GPIO_CRL_CNF5_Pos + 1U))
+#define GPIO_CRL_MODE6_Pos (24U)
+#define GPIO_CRL_MODE6_Msk (0x3U << GPIO_CRL_MODE6_Pos)
+#define GPIO_CRL_MODE6 GPIO_CRL_MODE6_Msk
+#define GPIO_CRL_MODE6_0 (0x1U << (GPIO_CRL_MODE6_Pos + 0U))
+#define GPIO_CRL_MODE6_1 (0x1U << (GPIO_CRL_MODE6_Pos + 1U))
+#define GPIO_CRL_CNF6_Pos (26U)
+#define GPIO_CRL_CNF6_Msk (0x3U << GPIO_CRL_CNF6_Pos)
+#define GPIO_CRL_CNF6 GPIO_CRL_CNF6_Msk
+#define GPIO_CRL_CNF6_0 (0x1U << (GPIO_CRL_CNF6_Pos + 0U))
+#define GPIO_CRL_CNF6_1 (0x1U << (GPIO_CRL_CNF6_Pos + 1U))
+#define GPIO_CRL_MODE7_Pos (28U)
+#define GPIO_CRL_MODE7_Msk (0x3U << GPIO_CRL_MODE7_Pos)
+#define GPIO_CRL_MODE7 GPIO_CRL_MODE7_Msk
+#define GPIO_CRL_MODE7_0 (0x1U << (GPIO_CRL_MODE7_Pos + 0U))
+#define GPIO_CRL_MODE7_1 (0x1U << (GPIO_CRL_MODE7_Pos + 1U))
+#define GPIO_CRL_CNF7_Pos (30U)
+#define GPIO_CRL_CNF7_Msk (0x3U << GPIO_CRL_CNF7_Pos)
+#define GPIO_CRL_CNF7 GPIO_CRL_CNF7_Msk
+#define GPIO_CRL_CNF7_0 (0x1U << (GPIO_CRL_CNF7_Pos + 0U))
+#define GPIO_CRL_CNF7_1 (0x1U << (GPIO_CRL_CNF7_Pos + 1U))
+
+// GPIO IDR
+#define GPIO_IDR_IDR0_Pos (0U)
+#define GPIO_IDR_IDR0_Msk (0x1U << GPIO_IDR_IDR0_Pos)
+#define GPIO_IDR_IDR0 GPIO_IDR_IDR0_Msk
+#define GPIO_IDR_IDR1_Pos (1U)
+#define GPIO_IDR_IDR1_Msk (0x1U << GPIO_IDR_IDR1_Pos)
+#define GPIO_IDR_IDR1 GPIO_IDR_IDR1_Msk
+#define GPIO_IDR_IDR2_Pos (2U)
+#define GPIO_IDR_IDR2_Msk (0x1U << GPIO_IDR_IDR2_Pos)
+#define GPIO_IDR_IDR2 GPIO_IDR_IDR2_Msk
+#define GPIO_IDR_IDR3_Pos (3U)
+#define GPIO_IDR_IDR3_Msk (0x1U << GPIO_IDR_IDR3_Pos)
+#define GPIO_IDR_IDR3 GPIO_IDR_IDR3_Msk
+#define GPIO_IDR_IDR4_Pos (4U)
+#define GPIO_IDR_IDR4_Msk (0x1U << GPIO_IDR_IDR4_Pos)
+#define GPIO_IDR_IDR4 GPIO_IDR_IDR4_Msk
+#define GPIO_IDR_IDR5_Pos (5U)
+#define GPIO_IDR_IDR5_Msk (0x1U << GPIO_IDR_IDR5_Pos)
+#define GPIO_IDR_IDR5 GPIO_IDR_IDR5_Msk
+#define GPIO_IDR_IDR6_Pos (6U)
+#define GPIO_IDR_IDR6_Msk (0x1U << GPIO_IDR_IDR6_Pos)
+#define GPIO_IDR_IDR6 GPIO_IDR_IDR6_Msk
+#define GPIO_IDR_IDR7_Pos (7U)
+#define GPIO_IDR_IDR7_Msk (0x1U << GPIO_IDR_IDR7_Pos)
+#define GPIO_IDR_IDR7 GPIO_IDR_IDR7_Msk
+#define GPIO_IDR_IDR8_Pos (8U)
+#define GPIO_IDR_IDR8_Msk (0x1U << GPIO_IDR_IDR8_Pos)
+#define GPIO_IDR_IDR8 GPIO_IDR_IDR8_Msk
+#define GPIO_IDR_IDR9_Pos (9U)
+#define GPIO_IDR_IDR9_Msk (0x1U << GPIO_IDR_IDR9_Pos)
+#define GPIO_IDR_IDR9 GPIO_IDR_IDR9_Msk
+#define GPIO_IDR_IDR10_Pos (10U)
+#define GPIO_IDR_IDR10_Msk (0x1U << GPIO_IDR_IDR10_Pos)
+#define GPIO_IDR_IDR10 GPIO_IDR_IDR10_Msk
+#define GPIO_IDR_IDR11_Pos (11U)
+#define GPIO_IDR_IDR11_Msk (0x1U << GPIO_IDR_IDR11_Pos)
+#define GPIO_IDR_IDR11 GPIO_IDR_IDR11_Msk
+#define GPIO_IDR_IDR12_Pos (12U)
+#define GPIO_IDR_IDR12_Msk (0x1U << GPIO_IDR_IDR12_Pos)
+#define GPIO_IDR_IDR12 GPIO_IDR_IDR12_Msk
+#define GPIO_IDR_IDR13_Pos (13U)
+#define GPIO_IDR_IDR13_Msk (0x1U << GPIO_IDR_IDR13_Pos)
+#define GPIO_IDR_IDR13 GPIO_IDR_IDR13_Msk
+#define GPIO_IDR_IDR14_Pos (14U)
+#define GPIO_IDR_IDR14_Msk (0x1U << GPIO_IDR_IDR14_Pos)
+#define GPIO_IDR_IDR14 GPIO_IDR_IDR14_Msk
+#define GPIO_IDR_IDR15_Pos (15U)
+#define GPIO_IDR_IDR15_Msk (0x1U << GPIO_IDR_IDR15_Pos)
+#define GPIO_IDR_IDR15 GPIO_IDR_IDR15_Msk
+
+// GPIO ODR
+#define GPIO_ODR_ODR0_Pos (0U)
+#define GPIO_ODR_ODR0_Msk (0x1U << GPIO_ODR_ODR0_Pos)
+#define GPIO_ODR_ODR0 GPIO_ODR_ODR0_Msk
+#define GPIO_ODR_ODR1_Pos (1U)
+#define GPIO_ODR_ODR1_Msk (0x1U << GPIO_ODR_ODR1_Pos)
+#define GPIO_ODR_ODR1 GPIO_ODR_ODR1_Msk
+#define GPIO_ODR_ODR2_Pos (2U)
+#define GPIO_ODR_ODR2_Msk (0x1U << GPIO_ODR_ODR2_Pos)
+#define GPIO_ODR_ODR2 GPIO_ODR_ODR2_Msk
+#define GPIO_ODR_ODR3_Pos (3U)
+#define GPIO_ODR_ODR3_Msk (0x1U << GPIO_ODR_ODR3_Pos)
+#define GPIO_ODR_ODR3 GPIO_ODR_ODR3_Msk
+#define GPIO_ODR_ODR4_Pos (4U)
+#define GPIO_ODR_ODR4_Msk (0x1U << GPIO_ODR_ODR4_Pos)
+#define GPIO_ODR_ODR4 GPIO_ODR_ODR4_Msk
+#define GPIO_ODR_ODR5_Pos (5U)
+#define GPIO_ODR_ODR5_Msk (0x1U << GPIO_ODR_ODR5_Pos)
+#define GPIO_ODR_ODR5 GPIO_ODR_ODR5_Msk
+#define GPIO_ODR_ODR6_Pos (6U)
+#define GPIO_ODR_ODR6_Msk (0x1U << GPIO_ODR_ODR6_Pos)
+#define GPIO_ODR_ODR6 GPIO_ODR_ODR6_Msk
+#define GPIO_ODR_ODR7_Pos (7U)
+#define GPIO_ODR_ODR7_Msk (0x1U << GPIO_ODR_ODR7_Pos)
+#define GPIO_ODR_ODR7 GPIO_ODR_ODR7_Msk
+#define GPIO_ODR_ODR8_Pos (8U)
+#define GPIO_ODR_ODR8_Msk (0x1U << GPIO_ODR_ODR8_Pos)
+#define GPIO_ODR_ODR8 GPIO_ODR_ODR8_Msk
+#define GPIO_ODR_ODR9_Pos (9U)
+#define GPIO_ODR_ODR9_Msk (0x1U << GPIO_ODR_ODR9_Pos)
+#define GPIO_ODR_ODR9 GPIO_ODR_ODR9_Msk
+#define GPIO_ODR_ODR10_Pos (10U)
+#define GPIO_ODR_ODR10_Msk (0x1U << GPIO_ODR_ODR10_Pos)
+#define GPIO_ODR_ODR10 GPIO_ODR_ODR10_Msk
+#define GPIO_ODR_ODR11_Pos (11U)
+#define GPIO_ODR_ODR11_Msk (0x1U << GPIO_ODR_ODR11_Pos)
+#define GPIO_ODR_ODR11 GPIO_ODR_ODR11_Msk
+#define GPIO_ODR_ODR12_Pos (12U)
+#define GPIO_ODR_ODR12_Msk (0x1U << GPIO_ODR_ODR12_Pos)
+#define GPIO_ODR_ODR12 GPIO_ODR_ODR12_Msk
+#define GPIO_ODR_ODR13_Pos (13U)
+#define GPIO_ODR_ODR13_Msk (0x1U << GPIO_ODR_ODR13_Pos)
+#define GPIO_ODR_ODR13 GPIO_ODR_ODR13_Msk
+#define GPIO_ODR_ODR14_Pos (14U)
+#define GPIO_ODR_ODR14_Msk (0x1U << GPIO_ODR_ODR14_Pos)
+#define GPIO_ODR_ODR14 GPIO_ODR_ODR14_Msk
+#define GPIO_ODR_ODR15_Pos (15U)
+#define GPIO_ODR_ODR15_Msk (0x1U << GPIO_ODR_ODR15_Pos)
+#define GPIO_ODR_ODR15 GPIO_ODR_ODR15_Msk
+
+// GPIO BSRR
+#define GPIO_BSRR_BS0_Pos (0U)
+#define GPIO_BSRR_BS0_Msk (0x1U << GPIO_BSRR_BS0_Pos)
+#define GPIO_BSRR_BS0 GPIO_BSRR_BS0_Msk
+#define GPIO_BSRR_BR0_Pos (16U)
+#define GPIO_BSRR_BR0_Msk (0x1U << GPIO_BSRR_BR0_Pos)
+#define GPIO_BSRR_BR0 GPIO_BSRR_BR0_Msk
+#define GPIO_BSRR_BS1_Pos (1U)
+#define GPIO_BSRR_BS1_Msk (0x1U << GPIO_BSRR_BS1_Pos)
+#define GPIO_BSRR_BS1 GPIO_BSRR_BS1_Msk
+#define GPIO_BSRR_BR1_Pos (17U)
+#define GPIO_BSRR_BR1_Msk (0x1U << GPIO_BSRR_BR1_Pos)
+#define GPIO_BSRR_BR1 GPIO_BSRR_BR1_Msk
+#define GPIO_BSRR_BS2_Pos (2U)
+#define GPIO_BSRR_BS2_Msk (0x1U << GPIO_BSRR_BS2_Pos)
+#define GPIO_BSRR_BS2 GPIO_BSRR_BS2_Msk
+#define GPIO_BSRR_BR2_Pos (18U)
+#define GPIO_BSRR_BR2_Msk (0x1U << GPIO_BSRR_BR2_Pos)
+#define GPIO_BSRR_BR2 GPIO_BSRR_BR2_Msk
+#define GPIO_BSRR_BS3_Pos (3U)
+#define GPIO_BSRR_BS3_Msk (0x1U << GPIO_BSRR_BS3_Pos)
+#define GPIO_BSRR_BS3 GPIO_BSRR_BS3_Msk
+#define GPIO_BSRR_BR3_Pos (19U)
+#define GPIO_BSRR_BR3_Msk (0x1U << GPIO_BSRR_BR3_Pos)
+#define GPIO_BSRR_BR3 GPIO_BSRR_BR3_Msk
+#define GPIO_BSRR_BS4_Pos (4U)
+#define GPIO_BSRR_BS4_Msk (0x1U << GPIO_BSRR_BS4_Pos)
+#define GPIO_BSRR_BS4 GPIO_BSRR_BS4_Msk
+#define GPIO_BSRR_BR4_Pos (20U)
+#define GPIO_BSRR_BR4_Msk (0x1U << GPIO_BSRR_BR4_Pos)
+#define GPIO_BSRR_BR4 GPIO_BSRR_BR4_Msk
+#define GPIO_BSRR_BS5_Pos (5U)
+#define GPIO_BSRR_BS5_Msk (0x1U << GPIO_BSRR_BS5_Pos)
+#define GPIO_BSRR_BS5 GPIO_BSRR_BS5_Msk
+#define GPIO_BSRR_BR5_Pos (21U)
+#define GPIO_BSRR_BR5_Msk (0x1U << GPIO_BSRR_BR5_Pos)
+#define GPIO_BSRR_BR5 GPIO_BSRR_BR5_Msk
+#define GPIO_BSRR_BS6_Pos (6U)
+#define GPIO_BSRR_BS6_Msk (0x1U << GPIO_BSRR_BS6_Pos)
+#define GPIO_BSRR_BS6 GPIO_BSRR_BS6_Msk
+#define GPIO_BSRR_BR6_Pos (22U)
+#define GPIO_BSRR_BR6_Msk (0x1U << GPIO_BSRR_BR6_Pos)
+#define GPIO_BSRR_BR6 GPIO_BSRR_BR6_Msk
+#define GPIO_BSRR_BS7_Pos (7U)
+#define GPIO_BSRR_BS7_Msk (0x1U << GPIO_BSRR_BS7_Pos)
+#define GPIO_BSRR_BS7 GPIO_BSRR_BS7_Msk
+#define GPIO_BSRR_BR7_Pos (23U)
+#define GPIO_BSRR_BR7_Msk (0x1U << GPIO_BSRR_BR7_Pos)
+#define GPIO_BSRR_BR7 GPIO_BSRR_BR7_Msk
+#define GPIO_BSRR_BS8_Pos (8U)
+#define GPIO_BSRR_BS8_Msk (0x1U << GPIO_BSRR_BS8_Pos)
+#define GPIO_BSRR_BS8 GPIO_BSRR_BS8_Msk
+#define GPIO_BSRR_BR8_Pos (24U)
+#define GPIO_BSRR_BR8_Msk (0x1U << GPIO_BSRR_BR8_Pos)
+#define GPIO_BSRR_BR8 GPIO_BSRR_BR8_Msk
+#define GPIO_BSRR_BS9_Pos (9U)
+#define GPIO_BSRR_BS9_Msk (0x1U << GPIO_BSRR_BS9_Pos)
+#define GPIO_BSRR_BS9 GPIO_BSRR_BS9_Msk
+#define GPIO_BSRR_BR9_Pos (25U)
+#define GPIO_BSRR_BR9_Msk (0x1U << GPIO_BSRR_BR9_Pos)
+#define GPIO_BSRR_BR9 GPIO_BSRR_BR9_Msk
+#define GPIO_BSRR_BS10_Pos (10U)
+#define GPIO_BSRR_BS10_Msk (0x1U << GPIO_BSRR_BS10_Pos)
+#define GPIO_BSRR_BS10 GPIO_BSRR_BS10_Msk
+#define GPIO_BSRR_BR10_Pos (26U)
+#define GPIO_BSRR_BR10_Msk (0x1U << GPIO_BSRR_BR10_Pos)
+#define GPIO_BSRR_BR10 GPIO_BSRR_BR10_Msk
+#define GPIO_BSRR_BS11_Pos (11U)
+#define GPIO_BSRR_BS11_Msk (0x1U << GPIO_BSRR_BS11_Pos)
+#define GPIO_BSRR_BS11 GPIO_BSRR_BS11_Msk
+#define GPIO_BSRR_BR11_Pos (27U)
+#define GPIO_BSRR_BR11_Msk (0x1U << GPIO_BSRR_BR11_Pos)
+#define GPIO_BSRR_BR11 GPIO_BSRR_BR11_Msk
+#define GPIO_BSRR_BS12_Pos (12U)
+#define GPIO_BSRR_BS12_Msk (0x1U << GPIO_BSRR_BS12_Pos)
+#define GPIO_BSRR_BS12 GPIO_BSRR_BS12_Msk
+#define GPIO_BSRR_BR12_Pos (28U)
+#define GPIO_BSRR_BR12_Msk (0x1U << GPIO_BSRR_BR12_Pos)
+#define GPIO_BSRR_BR12 GPIO_BSRR_BR12_Msk
+#define GPIO_BSRR_BS13_Pos (13U)
+#define GPIO_BSRR_BS13_Msk (0x1U << GPIO_BSRR_BS13_Pos)
+#define GPIO_BSRR_BS13 GPIO_BSRR_BS13_Msk
+#define GPIO_BSRR_BR13_Pos (29U)
+#define GPIO_BSRR_BR13_Msk (0x1U << GPIO_BSRR_BR13_Pos)
+#define GPIO_BSRR_BR13 GPIO_BSRR_BR13_Msk
+#define GPIO_BSRR_BS14_Pos (14U)
+#define GPIO_BSRR_BS14_Msk (0x1U << GPIO_BSRR_BS14_Pos)
+#define GPIO_BSRR_BS14 GPIO_BSRR_BS14_Msk
+#define GPIO_BSRR_BR14_Pos (30U)
+#define GPIO_BSRR_BR14_Msk (0x1U << GPIO_BSRR_BR14_Pos)
+#define GPIO_BSRR_BR14 GPIO_BSRR_BR14_Msk
+#define GPIO_BSRR_BS15_Pos (15U)
+#define GPIO_BSRR_BS15_Msk (0x1U << GPIO_BSRR_BS15_Pos)
+#define GPIO_BSRR_BS15 GPIO_BSRR_BS15_Msk
+#define GPIO_BSRR_BR15_Pos (31U)
+#define GPIO_BSRR_BR15_Msk (0x1U << GPIO_BSRR_BR15_Pos)
+#define GPIO_BSRR_BR15 GPIO_BSRR_BR15_Msk
+
+// GPIO BRR
+#define GPIO_BRR_BR0_Pos (0U)
+#define GPIO_BRR_BR0_Msk (0x1U << GPIO_BRR_BR0_Pos)
+#define GPIO_BRR_BR0 GPIO_BRR_BR0_Msk
+#define GPIO_BRR_BR1_Pos (1U)
+#define GPIO_BRR_BR1_Msk (0x1U << GPIO_BRR_BR1_Pos)
+#define GPIO_BRR_BR1 GPIO_BRR_BR1_Msk
+#define GPIO_BRR_BR2_Pos (2U)
+#define GPIO_BRR_BR2_Msk (0x1U << GPIO_BRR_BR2_Pos)
+#define GPIO_BRR_BR2 GPIO_BRR_BR2_Msk
+#define GPIO_BRR_BR3_Pos (3U)
+#define GPIO_BRR_BR3_Msk (0x1U << GPIO_BRR_BR3_Pos)
+#define GPIO_BRR_BR3 GPIO_BRR_BR3_Msk
+#define GPIO_BRR_BR4_Pos (4U)
+#define GPIO_BRR_BR4_Msk (0x1U << GPIO_BRR_BR4_Pos)
+#define GPIO_BRR_BR4 GPIO_BRR_BR4_Msk
+#define GPIO_BRR_BR5_Pos (5U)
+#define GPIO_BRR_BR5_Msk (0x1U << GPIO_BRR_BR5_Pos)
+#define GPIO_BRR_BR5 GPIO_BRR_BR5_Msk
+#define GPIO_BRR_BR6_Pos (6U)
+#define GPIO_BRR_BR6_Msk (0x1U << GPIO_BRR_BR6_Pos)
+#define GPIO_BRR_BR6 GPIO_BRR_BR6_Msk
+#define GPIO_BRR_BR7_Pos (7U)
+#define GPIO_BRR_BR7_Msk (0x1U << GPIO_BRR_BR7_Pos)
+#define GPIO_BRR_BR7 GPIO_BRR_BR7_Msk
+#define GPIO_BRR_BR8_Pos (8U)
+#define GPIO_BRR_BR8_Msk (0x1U << GPIO_BRR_BR8_Pos)
+#define GPIO_BRR_BR8 GPIO_BRR_BR8_Msk
+#define GPIO_BRR_BR9_Pos (9U)
+#define GPIO_BRR_BR9_Msk (0x1U << GPIO_BRR_BR9_Pos)
+#define GPIO_BRR_BR9 GPIO_BRR_BR9_Msk
+#define GPIO_BRR_BR10_Pos (10U)
+#define GPIO_BRR_BR10_Msk (0x1U << GPIO_BRR_BR10_Pos)
+#define GPIO_BRR_BR10 GPIO_BRR_BR10_Msk
+#define GPIO_BRR_BR11_Pos (11U)
+#define GPIO_BRR_BR11_Msk (0x1U << GPIO_BRR_BR11_Pos)
+#define GPIO_BRR_BR11 GPIO_BRR_BR11_Msk
+#define GPIO_BRR_BR12_Pos (12U)
+#define GPIO_BRR_BR12_Msk (0x1U << GPIO_BRR_BR12_Pos)
+#define GPIO_BRR_BR12 GPIO_BRR_BR12_Msk
+#define GPIO_BRR_BR13_Pos (13U)
+#define GPIO_BRR_BR13_Msk (0x1U << GPIO_BRR_BR13_Pos)
+#define GPIO_BRR_BR13 GPIO_BRR_BR13_Msk
+#define GPIO_BRR_BR14_Pos (14U)
+#define GPIO_BRR_BR14_Msk (0x1U << GPIO_BRR_BR14_Pos)
+#define GPIO_BRR_BR14 GPIO_BRR_BR14_Msk
+#define GPIO_BRR_BR15_Pos (15U)
+#define GPIO_BRR_BR15_Msk (0x1U << GPIO_BRR_BR15_Pos)
+#define GPIO_BRR_BR15 GPIO_BRR_BR15_Msk
+
+// GPIO CRH
+#define GPIO_CRH_MODE8_Pos (0U)
+#define GPIO_CRH_MODE8_Msk (0x3U << GPIO_CRH_MODE8_Pos)
+#define GPIO_CRH_MODE8 GPIO_CRH_MODE8_Msk
+#define GPIO_CRH_MODE8_0 (0x1U << (GPIO_CRH_MODE8_Pos + 0U))
+#define GPIO_CRH_MODE8_1 (0x1U << (GPIO_CRH_MODE8_Pos + 1U))
+#define GPIO_CRH_CNF8_Pos (2U)
+#define GPIO_CRH_CNF8_Msk (0x3U << GPIO_CRH_CNF8_Pos)
+#define GPIO_CRH_CNF8 GPIO_CRH_CNF8_Msk
+#define GPIO_CRH_CNF8_0 (0x1U << (GPIO_CRH_CNF8_Pos + 0U))
+#define GPIO_CRH_CNF8_1 (0x1U << (GPIO_CRH_CNF8_Pos + 1U))
+#define GPIO_CRH_MODE9_Pos (4U)
+#define GPIO_CRH_MODE9_Msk (0x3U << GPIO_CRH_MODE9_Pos)
+#define GPIO_CRH_MODE9 GPIO_CRH_MODE9_Msk
+#define GPIO_CRH_MODE9_0 (0x1U << (GPIO_CRH_MODE9_Pos + 0U))
+#define GPIO_CRH_MODE9_1 (0x1U << (GPIO_CRH_MODE9_Pos + 1U))
+#define GPIO_CRH_CNF9_Pos (6U)
+#define GPIO_CRH_CNF9_Msk (0x3U << GPIO_CRH_CNF9_Pos)
+#define GPIO_CRH_CNF9 GPIO_CRH_CNF9_Msk
+#define GPIO_CRH_CNF9_0 (0x1U << (GPIO_CRH_CNF9_Pos + 0U))
+#define GPIO_CRH_CNF9_1 (0x1U << (GPIO_CRH_CNF9_Pos + 1U))
+#define GPIO_CRH_MODE10_Pos (8U)
+#define GPIO_CRH_MODE10_Msk (0x3U << GPIO_CRH_MODE10_Pos)
+#define GPIO_CRH_MODE10 GPIO_CRH_MODE10_Msk
+#define GPIO_CRH_MODE10_0 (0x1U << (GPIO_CRH_MODE10_Pos + 0U))
+#define GPIO_CRH_MODE10_1 (0x1U << (GPIO_CRH_MODE10_Pos + 1U))
+#define GPIO_CRH_CNF10_Pos (10U)
+#define GPIO_CRH_CNF10_Msk (0x3U << GPIO_CRH_CNF10_Pos)
+#define GPIO_CRH_CNF10 GPIO_CRH_CNF10_Msk
+#define GPIO_CRH_CNF10_0 (0x1U << (GPIO_CRH_CNF10_Pos + 0U))
+#define GPIO_CRH_CNF10_1 (0x1U << (GPIO_CRH_CNF10_Pos + 1U))
+#define GPIO_CRH_MODE11_Pos (12U)
+#define GPIO_CRH_MODE11_Msk (0x3U << GPIO_CRH_MODE11_Pos)
+#define GPIO_CRH_MODE11 GPIO_CRH_MODE11_Msk
+#define GPIO_CRH_MODE11_0 (0x1U << (GPIO_CRH_MODE11_Pos + 0U))
+#define GPIO_CRH_MODE11_1 (0x1U << (GPIO_CRH_MODE11_Pos + 1U))
+#define GPIO_CRH_CNF11_Pos (14U)
+#define GPIO_CRH_CNF11_Msk (0x3U << GPIO_CRH_CNF11_Pos)
+#define GPIO_CRH_CNF11 GPIO_CRH_CNF11_Msk
+#define GPIO_CRH_CNF11_0 (0x1U << (GPIO_CRH_CNF11_Pos + 0U))
+#define GPIO_CRH_CNF11_1 (0x1U << (GPIO_CRH_CNF11_Pos + 1U))
+#define GPIO_CRH_MODE12_Pos (16U)
+#define GPIO_CRH_MODE12_Msk (0x3U << GPIO_CRH_MODE12_Pos)
+#define GPIO_CRH_MODE12 GPIO_CRH_MODE12_Msk
+#define GPIO_CRH_MODE12_0 (0x1U << (GPIO_CRH_MODE12_Pos + 0U))
+#define GPIO_CRH_MODE12_1 (0x1U << (GPIO_CRH_MODE12_Pos + 1U))
+#define GPIO_CRH_CNF12_Pos (18U)
+#define GPIO_CRH_CNF12_Msk (0x3U << GPIO_CRH_CNF12_Pos)
+#define GPIO_CRH_CNF12 GPIO_CRH_CNF12_Msk
+#define GPIO_CRH_CNF12_0 (0x1U << (GPIO_CRH_CNF12_Pos + 0U))
+#define GPIO_CRH_CNF12_1 (0x1U << (GPIO_CRH_CNF12_Pos + 1U))
+#define GPIO_CRH_MODE13_Pos (20U)
+#define GPIO_CRH_MODE13_Msk (0x3U << GPIO_CRH_MODE13_Pos)
+#define GPIO_CRH_MODE13 GPIO_CRH_MODE13_Msk
+#define GPIO_CRH_MODE13_0 (0x1U << (GPIO_CRH_MODE13_Pos + 0U))
+#define GPIO_CRH_MODE13_1 (0x1U << (GPIO_CRH_MODE13_Pos + 1U))
+#define GPIO_CRH_CNF13_Pos (22U)
+#define GPIO_CRH_CNF13_Msk (0x3U << GPIO_CRH_CNF13_Pos)
+#define GPIO_CRH_CNF13 GPIO_CRH_CNF13_Msk
+#define GPIO_CRH_CNF13_0 (0x1U << (GPIO_CRH_CNF13_Pos + 0U))
+#define GPIO_CRH_CNF13_1 (0x1U << (GPIO_CRH_CNF13_Pos + 1U))
+#define GPIO_CRH_MODE14_Pos (24U)
+#define GPIO_CRH_MODE14_Msk (0x3U << GPIO_CRH_MODE14_Pos)
+#define GPIO_CRH_MODE14 GPIO_CRH_MODE14_Msk
+#define GPIO_CRH_MODE14_0 (0x1U << (GPIO_CRH_MODE14_Pos + 0U))
+#define GPIO_CRH_MODE14_1 (0x1U << (GPIO_CRH_MODE14_Pos + 1U))
+#define GPIO_CRH_CNF14_Pos (26U)
+#define GPIO_CRH_CNF14_Msk (0x3U << GPIO_CRH_CNF14_Pos)
+#define GPIO_CRH_CNF14 GPIO_CRH_CNF14_Msk
+#define GPIO_CRH_CNF14_0 (0x1U << (GPIO_CRH_CNF14_Pos + 0U))
+#define GPIO_CRH_CNF14_1 (0x1U << (GPIO_CRH_CNF14_Pos + 1U))
+#define GPIO_CRH_MODE15_Pos (28U)
+#define GPIO_CRH_MODE15_Msk (0x3U << GPIO_CRH_MODE15_Pos)
+#define GPIO_CRH_MODE15 GPIO_CRH_MODE15_Msk
+#define GPIO_CRH_MODE15_0 (0x1U << (GPIO_CRH_MODE15_Pos + 0U))
+#define GPIO_CRH_MODE15_1 (0x1U << (GPIO_CRH_MODE15_Pos + 1U))
+#define GPIO_CRH_CNF15_Pos (30U)
+#define GPIO_CRH_CNF15_Msk (0x3U << GPIO_CRH_CNF15_Pos)
+#define GPIO_CRH_CNF15 GPIO_CRH_CNF15_Msk
+#define GPIO_CRH_CNF15_0 (0x1U << (GPIO_CRH_CNF15_Pos + 0U))
+#define GPIO_CRH_CNF15_1 (0x1U << (GPIO_CRH_CNF15_Pos + 1U))
@@ -0,0 +1,118 @@
+// Host benchmark of the gear, phase delay, speed estimate and step ratio
+// kernels, built against the simulated peripherals like the sim:
+//   make bench && ./m-els-bench [--iterations N] [--ratio STEPS/COUNTS]
+// Host timings only compare builds with each other; `make bench-arm` gives
+// cycle estimates for the same kernels on the target.
+#include "../main.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "../sim/peripherals.hpp"
+#include "bench_kernels.hpp"
+
+namespace bench {
+
+    volatile uint32_t sink;
+
+    struct inputs {
+        std::vector<uint16_t> counts, periods;
+        std::vector<int> errors;
+        std::vector<bool> dirs;
+    };
+
+    // Fixed pseudo random inputs, the same for every run
+    inputs make_inputs(size_t n, const gear::Ratio& r) {
+        inputs in;
+        uint32_t x = 12345;
+        auto next = [&x]() { return x = x * 1664525 + 1013904223; };
+        for (size_t i = 0; i < n; i++) {
+            in.counts.push_back(next() >> 16);
+            in.periods.push_back(100 + (next() >> 20));
+            in.errors.push_back(r.lo + static_cast<int>((next() >> 8) % r.N));
+            in.dirs.push_back((next() >> 24) < 16); // mostly forward, as when threading
+        }
+        return in;
+    }
+
+    // Best of a few runs, in ns per call
+    template <typename F>
+    double time(uint32_t iterations, F f) {
+        double best = 1e99;
+        for (int run = 0; run < 5; run++) {
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                f(i);
+            }
+            std::chrono::duration<double, std::nano> t = std::chrono::steady_clock::now() - start;
+            best = std::min(best, t.count() / iterations);
+        }
+        return best;
+    }
+
+    void report(const char* name, double ns) {
+        printf("%-26s %8.2f ns\n", name, ns);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace bench;
+    uint32_t iterations = 1000000;
+    unsigned steps = 127, counts = 96; // 8 TPI on a 2 mm leadscrew at 2000/2400
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && strcmp(argv[i], "--iterations") == 0) {
+            iterations = static_cast<uint32_t>(atol(argv[i + 1]));
+        } else if (i + 1 < argc && strcmp(argv[i], "--ratio") == 0
+            && sscanf(argv[i + 1], "%u/%u", &steps, &counts) == 2 && steps != 0 && counts != 0) {
+        } else {
+            fprintf(stderr, "usage: m-els-bench [--iterations N] [--ratio STEPS/COUNTS]\n");
+            return 2;
+        }
+    }
+
+    app::init();
+    gear::configure(steps, counts, 0);
+    const gear::Ratio r = gear::make_ratio(counts, steps);
+    constexpr size_t Mask = 1023;
+    inputs in = make_inputs(Mask + 1, r);
+    printf("ratio %u/%u: D %d, N %d, burst %u, %u iterations\n", steps, counts, r.D, r.N, r.burst, iterations);
+
+    report("next_jump_forward", time(iterations, [&](uint32_t i) {
+        sink = bench_next_jump_forward(r.D, r.N, in.errors[i & Mask], in.counts[i & Mask]).count;
+    }));
+    report("next_jump_reverse", time(iterations, [&](uint32_t i) {
+        sink = bench_next_jump_reverse(r.D, r.N, in.errors[i & Mask], in.counts[i & Mask]).count;
+    }));
+    report("step_forward", time(iterations, [&](uint32_t i) {
+        sink = bench_step_forward(r.Q, r.R, r.N, r.lo, in.errors[i & Mask], in.counts[i & Mask]).count;
+    }));
+    report("step_reverse", time(iterations, [&](uint32_t i) {
+        sink = bench_step_reverse(r.Q, r.R, r.N, r.hi, in.errors[i & Mask] + r.hi - r.lo - r.N, in.counts[i & Mask]).count;
+    }));
+    uint16_t count = 0;
+    report("Range::next_jump", time(iterations, [&](uint32_t i) {
+        count = bench_range_next_jump(in.dirs[i & Mask], count);
+    }));
+    report("phase_delay", time(iterations, [&](uint32_t i) {
+        sink = bench_phase_delay(in.periods[i & Mask], in.errors[i & Mask]);
+    }));
+    report("phase_delay_div", time(iterations, [&](uint32_t i) {
+        sink = bench_phase_delay_div(in.periods[i & Mask], in.errors[i & Mask]);
+    }));
+    uint16_t reading = 0;
+    report("rpm process_sample", time(iterations, [&](uint32_t i) {
+        reading += in.counts[i & Mask] & 7;
+        bench_rpm_process_sample(reading);
+    }));
+    report("rpm sample + update", time(iterations, [&](uint32_t i) {
+        bench_rpm_process_sample(reading += in.counts[i & Mask] & 7);
+        bench_rpm_update();
+    }));
+    report("step_ratio", time(iterations / 16, [&](uint32_t i) {
+        auto& p = constants::pitch_presets[i % constants::pitch_preset_count];
+        sink = bench_step_ratio(p.num, p.denom, 2, 1, 2000, 2400);
+    }));
+    return 0;
+}
@@ -0,0 +1,4 @@
+// Target build of the benchmark kernels for `make bench-arm`, compiled to an
+// object file only and disassembled
+#include "../main.cpp"
+#include "bench_kernels.hpp"
@@ -0,0 +1,58 @@
+#pragma once
+// The arithmetic of the step ISR, the SysTick speed estimate and apply as
+// out of line functions, included after main.cpp. The host benchmark times
+// them and the target build disassembles them one symbol per kernel.
+#include <stdint.h>
+
+#define BENCH_KERNEL extern "C" __attribute__((noinline, used))
+
+BENCH_KERNEL gear::Jump bench_next_jump_forward(int d, int n, int e, uint16_t count) {
+    return gear::next_jump_forward(d, n, e, count);
+}
+
+BENCH_KERNEL gear::Jump bench_next_jump_reverse(int d, int n, int e, uint16_t count) {
+    return gear::next_jump_reverse(d, n, e, count);
+}
+
+BENCH_KERNEL gear::Jump bench_step_forward(int q, int r, int n, int lo, int e, uint16_t count) {
+    return gear::step_forward(q, r, n, lo, e, count);
+}
+
+BENCH_KERNEL gear::Jump bench_step_reverse(int q, int r, int n, int hi, int e, uint16_t count) {
+    return gear::step_reverse(q, r, n, hi, e, count);
+}
+
+// One jump of the compare interrupt with the installed ratio, err left at
+// the next jump as the interrupt seeds it, so consecutive calls walk the
+// thread in either direction without reversing
+BENCH_KERNEL uint16_t bench_range_next_jump(bool dir, uint16_t count) {
+    gear::range.next_jump(dir, count);
+    gear::state.err = gear::range.next.error;
+    return gear::range.next.count;
+}
+
+BENCH_KERNEL unsigned bench_phase_delay(uint16_t input_period, int e) {
+    return gear::phase_delay(input_period, e);
+}
+
+BENCH_KERNEL unsigned bench_phase_delay_div(uint16_t input_period, int e) {
+    return gear::phase_delay_div(input_period, e);
+}
+
+BENCH_KERNEL void bench_rpm_process_sample(uint16_t current_reading) {
+    devices::rpm_counter<>::process_sample(current_reading);
+}
+
+BENCH_KERNEL void bench_rpm_update() {
+    devices::rpm_counter<>::update();
+}
+
+// The step ratio for a pitch as on apply, 0 when it does not fit
+BENCH_KERNEL uint32_t bench_step_ratio(uint32_t pitch_num, uint32_t pitch_denom,
+    uint32_t leadscrew_num, uint32_t leadscrew_denom, uint32_t stepper, uint32_t encoder) {
+    uint32_t steps, counts;
+    if (!devices::i2c::step_ratio(pitch_num, pitch_denom, leadscrew_num, leadscrew_denom, stepper, encoder, steps, counts)) {
+        return 0;
+    }
+    return steps << 16 | counts;
+}
@@ -0,0 +1,112 @@
+"""Instruction counts and Cortex-M3 cycle estimates of the benchmark kernels.
+
+Reads `arm-none-eabi-objdump -d --no-show-raw-insn` output on stdin and
+sums the cycles of the Cortex-M3 TRM for every instruction of each bench_*
+symbol, as if it ran straight through once: loops count once, every branch
+is taken and memory has no wait states. The estimate only compares builds
+with each other. With --baseline the estimates are compared with a file
+written by --save and the exit status is 1 when a kernel grew by more than
+--tolerance percent.
+"""
+import argparse
+import re
+import sys
+
+BRANCH = 3  # 1 + pipeline refill
+CYCLES = {
+    'ldr': 2, 'ldrb': 2, 'ldrh': 2, 'ldrsb': 2, 'ldrsh': 2, 'ldrd': 3, 'ldrex': 2,
+    'mla': 2, 'mls': 2,
+    'umull': 5, 'smull': 5, 'umlal': 5, 'smlal': 5,
+    'udiv': 12, 'sdiv': 12,
+    'b': BRANCH, 'bl': BRANCH + 1, 'bx': BRANCH, 'blx': BRANCH + 1, 'cbz': BRANCH, 'cbnz': BRANCH,
+    'tbb': 2 + BRANCH, 'tbh': 2 + BRANCH,
+    'strd': 2, 'it': 0, 'ite': 0, 'itt': 0, 'itee': 0, 'itet': 0, 'itte': 0, 'ittt': 0,
+}
+CONDITIONS = ('eq', 'ne', 'cs', 'cc', 'hs', 'lo', 'mi', 'pl', 'vs', 'vc', 'hi', 'ls', 'ge', 'lt', 'gt', 'le', 'al')
+
+
+def base(mnemonic):
+    m = mnemonic.split('.')[0]
+    if m not in CYCLES and len(m) > 2 and m[-2:] in CONDITIONS:
+        m = m[:-2]
+    if m.endswith('s') and m[:-1] in CYCLES:
+        m = m[:-1]
+    return m
+
+
+def cycles(mnemonic, operands):
+    m = base(mnemonic)
+    registers = operands.count(',') + 1 if '{' in operands else 0
+    if m in ('push', 'stmdb', 'stmia', 'stm'):
+        return 1 + registers
+    if m in ('pop', 'ldmia', 'ldm', 'ldmdb'):
+        return 1 + registers + (BRANCH - 1 if 'pc' in operands else 0)
+    if m.startswith('it') and set(m[2:]) <= {'t', 'e'}:
+        return 0
+    if m in ('mov', 'add') and re.match(r'pc\b', operands):
+        return 1 + BRANCH
+    return CYCLES.get(m, 1)
+
+
+def parse(lines):
+    kernels = {}
+    name = None
+    for line in lines:
+        header = re.match(r'^[0-9a-f]+ <(\w+)>:', line)
+        if header:
+            name = header.group(1) if header.group(1).startswith('bench_') else None
+            if name:
+                kernels[name] = {'instructions': 0, 'cycles': 0, 'calls': []}
+            continue
+        insn = re.match(r'^\s+[0-9a-f]+:\s+([a-z][\w.]*)\s*(.*)$', line)
+        if not name or not insn:
+            continue
+        mnemonic, operands = insn.group(1), insn.group(2).split(';')[0].strip()
+        k = kernels[name]
+        k['instructions'] += 1
+        k['cycles'] += cycles(mnemonic, operands)
+        if base(mnemonic) in ('bl', 'blx'):
+            callee = re.search(r'<([^>+]+)', operands)
+            k['calls'].append(callee.group(1) if callee else operands)
+    return kernels
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--save', help='write the estimates to this file')
+    parser.add_argument('--baseline', help='compare with estimates written by --save')
+    parser.add_argument('--tolerance', type=float, default=10, help='allowed growth in percent')
+    args = parser.parse_args()
+
+    kernels = parse(sys.stdin)
+    if not kernels:
+        sys.exit('cycle_estimate: no bench_ symbols in the disassembly')
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            for line in f:
+                fields = line.split()
+                if len(fields) == 3:
+                    baseline[fields[0]] = int(fields[2])
+
+    grown = []
+    print('%-28s %6s %7s  %s' % ('kernel', 'insns', 'cycles', 'calls'))
+    for name, k in kernels.items():
+        note = ' '.join(k['calls'])
+        if name in baseline:
+            before = baseline[name]
+            note = ('was %d ' % before) + note
+            if k['cycles'] > before * (1 + args.tolerance / 100):
+                grown.append(name)
+        print('%-28s %6d %7d  %s' % (name[len('bench_'):], k['instructions'], k['cycles'], note))
+    if args.save:
+        with open(args.save, 'w') as f:
+            for name, k in kernels.items():
+                f.write('%s %d %d\n' % (name, k['instructions'], k['cycles']))
+    if grown:
+        print('cycle_estimate: grew by more than %g%%: %s' % (args.tolerance, ' '.join(grown)), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,300 @@
+// Exhaustive accuracy sweep of the gear on the host, on all cores:
+//   make sweep && ./m-els-sweep [--pitch-max N] [--counts N] [--threads N] [--max-error STEPS] [--csv FILE]
+// Every pitch num/denom up to --pitch-max on the common encoder and stepper
+// resolutions and leadscrews is reduced as on apply. Each distinct step ratio
+// then follows a spindle that turns back and forth for --counts encoder counts
+// through gear::range as the compare interrupt does, every other ratio with a
+// deadband, and halfway through changes to another ratio, which the range
+// adopts at its next jump. Each is checked for
+//   - the burst, at most one jump per count with the fewest pulses per jump
+//   - position error, the leadscrew against the encoder count times the
+//     ratio, which should stay within one jump and half a step, and within
+//     --max-error steps when it is given
+//   - drift, the error the gear keeps against the exact error, which should
+//     stay 0 however long it runs
+//   - illegal jumps, a forward jump of 0 counts or one that does not fit the
+//     16 bit compare, which the narrowing in gear.hpp would hide
+#define MELS_GEAR_STORAGE thread_local // one gear per thread
+#include "../main.cpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../sim/peripherals.hpp"
+
+namespace sweep {
+
+    constexpr uint16_t encoders[] = { 400, 600, 1000, 1024, 2000, 2048, 2400, 4000, 4096, 8192 };
+    constexpr uint16_t steppers[] = { 200, 400, 800, 1000, 1600, 2000, 3200, 4000, 6400, 12800, 25600 };
+    constexpr constants::pitch_t leadscrews[] = { { 1, 1 }, { 2, 1 }, { 5, 2 }, { 3, 1 }, { 4, 1 }, { 5, 1 },
+        { 127, 20 }, { 127, 40 }, { 127, 50 }, { 127, 80 } }; // mm, the last are 4, 8, 10 and 16 TPI
+
+    struct result {
+        uint32_t steps, counts;
+        uint16_t deadband = 0;
+        double max_error = 0; // steps
+        double bound = 0; // steps, one jump and half a step of either ratio
+        int64_t max_drift = 0; // in units of 1 / D jumps
+        uint64_t illegal = 0;
+        bool bad_burst = false;
+        uint64_t jumps = 0;
+    };
+
+    // The jump distances of gear::next_jump_forward() and next_jump_reverse()
+    // without the 16 bit narrowing
+    int64_t wide_forward(int64_t d, int64_t n, int64_t e) {
+        return (d - 2 * e + 2 * n - 1) / (2 * n);
+    }
+
+    int64_t wide_reverse(int64_t d, int64_t n, int64_t e) {
+        return 1 + (d + 2 * e) / (2 * n);
+    }
+
+    // The burst make_ratio() picked: at most one jump per count, the fewest
+    // pulses that allow it, and the jumps times the burst give the ratio
+    bool burst_ok(const gear::Ratio& g, uint32_t steps, uint32_t counts) {
+        return g.burst >= 1 && g.burst <= devices::step_gen::Max_burst
+            && g.burst == (steps + counts - 1) / counts && g.N <= g.D
+            && static_cast<uint64_t>(g.N) * g.burst * counts == static_cast<uint64_t>(steps) * g.D;
+    }
+
+    void install(uint8_t slot, const gear::Ratio& r) {
+        auto& s = gear::state.ratio[slot];
+        s.D = r.D;
+        s.N = r.N;
+        s.incremental = r.incremental;
+        s.Q = r.Q;
+        s.R = r.R;
+        s.lo = r.lo;
+        s.hi = r.hi;
+        s.inv_N = r.inv_N;
+        s.burst = r.burst;
+    }
+
+    // Follow a spindle turning back and forth for total encoder counts, with
+    // a pseudo random pattern that is the same for every ratio, through
+    // gear::range as the compare interrupt does, with the given deadband.
+    // Halfway through the ratio changes to other, which the range adopts at
+    // its next jump.
+    result run(std::pair<uint32_t, uint32_t> ratio, std::pair<uint32_t, uint32_t> other, uint16_t deadband, uint64_t total) {
+        result res{ ratio.first, ratio.second, deadband };
+        const gear::Ratio r = gear::make_ratio(ratio.second, ratio.first);
+        const gear::Ratio r2 = gear::make_ratio(other.second, other.first);
+        res.bad_burst = !burst_ok(r, ratio.first, ratio.second) || !burst_ok(r2, other.first, other.second);
+        res.bound = std::max(r.burst, r2.burst) + 0.5;
+        auto& s = gear::state;
+        auto& range = gear::range;
+        install(0, r);
+        s.active = 0;
+        s.pending = false;
+        s.err = 0;
+        range.deadband = deadband;
+        range.next_jump(false, 0); // as gear::restart() from count 0
+        bool dir = false; // of the leadscrew, true in reverse
+        int64_t spindle = 0; // counts
+        // The error the gear should have at count c, in units of 1 / d jumps,
+        // from the phase e0 at count base and the jumps taken since
+        int64_t d = r.D, n = r.N, burst = r.burst;
+        int64_t base = 0, e0 = 0, jumps = 0;
+        auto exact = [&](int64_t c) {
+            return e0 + (c - base) * n - jumps * d;
+        };
+        uint32_t x = 12345;
+        int step = 1; // direction the spindle turns
+        uint64_t run_left = 0;
+        for (uint64_t i = 0; i < total; i++) {
+            if (i == total / 2) {
+                install(!s.active, r2);
+                s.pending = true;
+            }
+            if (run_left == 0) {
+                x = x * 1664525 + 1013904223;
+                // mostly long runs, sometimes a count or two of jitter, and
+                // runs back and forth within the deadband
+                run_left = (x >> 28) < 3 ? 1 + (x >> 20) % (3 + deadband) : 1 + (x >> 8) % (8 * d / n + 64);
+                step = (x >> 27) & 1 ? 1 : -1;
+            }
+            run_left--;
+            spindle += step;
+            uint16_t count = static_cast<uint16_t>(spindle);
+            bool fwd = count == range.next.count;
+            if (fwd || count == range.prev.count) {
+                if (!fwd) { // reversal, a step back at once
+                    dir = !dir;
+                }
+                jumps += dir ? -1 : 1;
+                s.err = fwd ? range.next.error : range.prev.error;
+                int64_t at = spindle + range.shift(dir); // the count the range works from
+                res.jumps++;
+                res.max_drift = std::max<int64_t>(res.max_drift, std::llabs(exact(at) - s.err));
+                uint8_t active = s.active;
+                int e = s.err;
+                range.next_jump(dir, count);
+                if (s.active != active) { // adopted, the phase carries over to the new ratio
+                    int64_t rescaled = static_cast<int64_t>(e) * r2.D * r.burst / (static_cast<int64_t>(r.D) * r2.burst) % r2.D;
+                    rescaled += rescaled < r2.lo ? r2.D : rescaled >= r2.hi ? -r2.D : 0;
+                    res.max_drift = std::max<int64_t>(res.max_drift, std::llabs(rescaled - s.err));
+                    d = r2.D;
+                    n = r2.N;
+                    burst = r2.burst;
+                    base = at;
+                    e0 = s.err;
+                    jumps = 0;
+                }
+                int64_t wide = dir ? wide_reverse(d, n, s.err) : wide_forward(d, n, s.err);
+                if (wide < 1 || wide > 0xFFFF || range.next.delta != wide) {
+                    res.illegal++;
+                }
+            }
+            // Against the count the encoder reads, the angle within a count
+            // is its resolution and not the gear's error. The leadscrew may
+            // follow any count within the deadband behind the spindle.
+            int64_t lo = exact(spindle), hi = exact(spindle + deadband);
+            int64_t off = lo <= 0 && hi >= 0 ? 0 : std::min(std::llabs(lo), std::llabs(hi));
+            res.max_error = std::max(res.max_error, static_cast<double>(off) * burst / d);
+        }
+        return res;
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace sweep;
+    uint32_t pitch_max = 32;
+    uint64_t total = 1000000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double max_error = 0; // steps, 0 checks against the bound of each ratio only
+    FILE* csv = nullptr;
+    for (int i = 1; i < argc; i += 2) {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value && strcmp(argv[i], "--pitch-max") == 0) {
+            pitch_max = atoi(value);
+        } else if (value && strcmp(argv[i], "--counts") == 0) {
+            total = strtoull(value, nullptr, 10);
+        } else if (value && strcmp(argv[i], "--threads") == 0) {
+            threads = std::max(1, atoi(value));
+        } else if (value && strcmp(argv[i], "--max-error") == 0) {
+            max_error = atof(value);
+        } else if (value && strcmp(argv[i], "--csv") == 0) {
+            csv = strcmp(value, "-") == 0 ? stdout : fopen(value, "w");
+        } else {
+            fprintf(stderr, "usage: m-els-sweep [--pitch-max N] [--counts N] [--threads N] [--max-error STEPS] [--csv FILE]\n");
+            return 2;
+        }
+    }
+
+    // every step ratio apply would accept, once
+    std::set<std::pair<uint32_t, uint32_t>> unique;
+    uint64_t combinations = 0, rejected = 0;
+    for (uint32_t num = 1; num <= pitch_max; num++) {
+        for (uint32_t denom = 1; denom <= pitch_max; denom++) {
+            if (std::gcd(num, denom) != 1) {
+                continue;
+            }
+            for (auto& l : leadscrews) {
+                for (auto encoder : encoders) {
+                    for (auto stepper : steppers) {
+                        combinations++;
+                        uint32_t steps, counts;
+                        if (!devices::i2c::step_ratio(num, denom, l.num, l.denom, stepper, encoder, steps, counts)
+                            || !devices::i2c::burst_fits(steps, counts)) {
+                            rejected++;
+                            continue;
+                        }
+                        unique.insert({ steps, counts });
+                    }
+                }
+            }
+        }
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> ratios(unique.begin(), unique.end());
+    fprintf(stderr, "%llu combinations, %llu rejected on apply, %zu distinct ratios, %llu counts each on %u threads\n",
+        static_cast<unsigned long long>(combinations), static_cast<unsigned long long>(rejected), ratios.size(),
+        static_cast<unsigned long long>(total), threads);
+
+    std::vector<result> results(ratios.size());
+    std::atomic<size_t> taken{ 0 };
+    std::atomic<size_t> done{ 0 };
+    std::mutex progress;
+    const char* progress_format = isatty(fileno(stderr)) ? "\r%zu/%zu" : "%zu/%zu\n"; // one line on a terminal
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&]() {
+            for (size_t i; (i = taken++) < ratios.size();) {
+                uint16_t deadband = i % 2 ? 1 + (i / 2) % 32 : 0;
+                results[i] = run(ratios[i], ratios[(i + ratios.size() / 2) % ratios.size()], deadband, total);
+                size_t finished = ++done;
+                if (finished % 1000 == 0) {
+                    std::lock_guard<std::mutex> lock(progress);
+                    fprintf(stderr, progress_format, finished, ratios.size());
+                }
+            }
+        });
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+    fprintf(stderr, progress_format, ratios.size(), ratios.size());
+    if (isatty(fileno(stderr))) {
+        fprintf(stderr, "\n");
+    }
+
+    if (csv) {
+        fprintf(csv, "steps,counts,deadband,max_error,max_drift,illegal_jumps,bad_burst,jumps\n");
+    }
+    result worst_error{}, worst_drift{};
+    uint64_t failed = 0, illegal = 0, jumps = 0, over_bound = 0, over_max = 0, bad_bursts = 0;
+    for (auto& r : results) {
+        if (csv) {
+            fprintf(csv, "%u,%u,%u,%.4f,%lld,%llu,%d,%llu\n", r.steps, r.counts, r.deadband, r.max_error,
+                static_cast<long long>(r.max_drift), static_cast<unsigned long long>(r.illegal), r.bad_burst,
+                static_cast<unsigned long long>(r.jumps));
+        }
+        bool beyond_bound = r.max_error > r.bound + 1e-9;
+        bool beyond_max = max_error > 0 && r.max_error > max_error + 1e-9;
+        over_bound += beyond_bound;
+        over_max += beyond_max;
+        bad_bursts += r.bad_burst;
+        if (r.illegal || r.max_drift || r.bad_burst || beyond_bound || beyond_max) {
+            if (failed++ < 20) {
+                printf("FAIL %u/%u deadband %u: max error %.3f steps (bound %.3f), drift %lld, %llu illegal jumps%s\n",
+                    r.steps, r.counts, r.deadband, r.max_error, r.bound, static_cast<long long>(r.max_drift),
+                    static_cast<unsigned long long>(r.illegal), r.bad_burst ? ", bad burst" : "");
+            }
+        }
+        if (r.max_error > worst_error.max_error) {
+            worst_error = r;
+        }
+        if (r.max_drift > worst_drift.max_drift) {
+            worst_drift = r;
+        }
+        illegal += r.illegal;
+        jumps += r.jumps;
+    }
+    if (csv && csv != stdout) {
+        fclose(csv);
+    }
+    printf("jumps:                 %llu\n", static_cast<unsigned long long>(jumps));
+    printf("max position error:    %.3f steps at %u/%u (bound %.3f)\n", worst_error.max_error, worst_error.steps, worst_error.counts,
+        worst_error.bound);
+    printf("beyond the bound:      %llu\n", static_cast<unsigned long long>(over_bound));
+    if (max_error > 0) {
+        printf("beyond --max-error:    %llu (%.3f steps)\n", static_cast<unsigned long long>(over_max), max_error);
+    }
+    if (worst_drift.max_drift) {
+        printf("max drift:             %lld at %u/%u\n", static_cast<long long>(worst_drift.max_drift), worst_drift.steps, worst_drift.counts);
+    } else {
+        printf("max drift:             none\n");
+    }
+    printf("illegal jumps:         %llu\n", static_cast<unsigned long long>(illegal));
+    printf("bad bursts:            %llu\n", static_cast<unsigned long long>(bad_bursts));
+    printf("failed ratios:         %llu of %zu\n", static_cast<unsigned long long>(failed), ratios.size());
+    return failed ? 1 : 0;
+}
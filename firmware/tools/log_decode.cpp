@@ -0,0 +1,46 @@
+// Decodes the driver's UART log from stdin, e.g.
+//   stty -F /dev/ttyUSB0 115200 raw && ./m-els-log < /dev/ttyUSB0
+// With --csv the telemetry records go to stdout as CSV and the other events
+// to stderr:
+//   stty -F /dev/ttyUSB0 1000000 raw && ./m-els-log --csv < /dev/ttyUSB0 > steps.csv
+#include <cstdio>
+#include <cstring>
+#include "log_decoder.hpp"
+
+int main(int argc, char** argv) {
+    bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+    if (argc > 2 || (argc == 2 && !csv)) {
+        fprintf(stderr, "usage: m-els-log [--csv]\n");
+        return 2;
+    }
+    tools::log_decoder decoder;
+    if (csv) {
+        printf("%s\n", decoder.Csv_header);
+    }
+    unsigned records = 0, gaps = 0;
+    uint16_t next = 0;
+    int ch;
+    while ((ch = getchar()) != EOF) {
+        if (!decoder.feed(static_cast<uint8_t>(ch))) {
+            continue;
+        }
+        devices::telemetry_record_t r;
+        if (csv && decoder.telemetry(r)) {
+            if (records++ && r.sequence != next) {
+                gaps++;
+            }
+            next = r.sequence + 1;
+            printf("%s\n", decoder.csv(r).c_str());
+        } else {
+            fprintf(csv ? stderr : stdout, "%s\n", decoder.text().c_str());
+        }
+        fflush(stdout);
+    }
+    if (decoder.bad_frames) {
+        fprintf(stderr, "m-els-log: %u bad frames\n", decoder.bad_frames);
+    }
+    if (csv) {
+        fprintf(stderr, "m-els-log: %u records, %u gaps in the sequence\n", records, gaps);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#pragma once
+// Turns the binary log frames from the UART back into events and text
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "../devices/log_format.hpp"
+
+namespace tools {
+
+    struct log_decoder {
+        using event = devices::log_format::event;
+
+        uint8_t frame[devices::log_format::Max_payload + 4];
+        uint8_t length = 0; // bytes of the current frame so far
+        unsigned bad_frames = 0;
+
+        // Feed one received byte, returns true once a valid frame is complete
+        bool feed(uint8_t b) {
+            if (length == 0 && b != devices::log_format::Sync) {
+                return false; // resynchronizing
+            }
+            frame[length++] = b;
+            if (length == 3 && frame[2] > devices::log_format::Max_payload) {
+                bad_frames++;
+                length = 0;
+                return false;
+            }
+            if (length < 4 || length < frame[2] + 4) {
+                return false;
+            }
+            length = 0;
+            uint8_t sum = 0;
+            for (uint8_t i = 1; i < frame[2] + 3; i++) {
+                sum += frame[i];
+            }
+            if (sum != frame[frame[2] + 3]) {
+                bad_frames++;
+                return false;
+            }
+            return true;
+        }
+
+        // Of the last complete frame
+        event type() const {
+            return static_cast<event>(frame[1]);
+        }
+
+        const uint8_t* payload() const {
+            return &frame[3];
+        }
+
+        uint8_t size() const {
+            return frame[2];
+        }
+
+        bool telemetry(devices::telemetry_record_t& r) const {
+            if (type() != event::telemetry || size() != sizeof(r)) {
+                return false;
+            }
+            std::memcpy(&r, payload(), sizeof(r));
+            return true;
+        }
+
+        std::string text() const {
+            const uint8_t* p = payload();
+            auto u16 = [p](int at) { return static_cast<unsigned>(p[at] | p[at + 1] << 8); };
+            auto u32 = [u16](int at) { return u16(at) | u16(at + 2) << 16; };
+            char buffer[96];
+            devices::telemetry_record_t r;
+            switch (type()) {
+            case event::overflow:
+                snprintf(buffer, sizeof(buffer), "%u log frames dropped", u16(0));
+                break;
+            case event::text:
+                return std::string(reinterpret_cast<const char*>(p), size());
+            case event::gear_changed:
+                snprintf(buffer, sizeof(buffer), "gears changed to %u/%u, %u steps per %u counts",
+                    u32(0), u32(4), u16(8), u16(10));
+                break;
+            case event::mode_set:
+                snprintf(buffer, sizeof(buffer), "set mode to %u", p[0]);
+                break;
+            case event::register_rejected:
+                snprintf(buffer, sizeof(buffer), "rejected register %u", p[0]);
+                break;
+            case event::control_changed:
+                snprintf(buffer, sizeof(buffer), "control %u", p[0]);
+                break;
+            case event::limit_reached:
+                snprintf(buffer, sizeof(buffer), "stopping at the %s limit", p[0] == 1 ? "left" : "right");
+                break;
+            case event::home_set:
+                if (u16(0) == 0xFFFF) {
+                    snprintf(buffer, sizeof(buffer), "homed before the index was seen");
+                } else {
+                    snprintf(buffer, sizeof(buffer), "homed %u counts past the index", u16(0));
+                }
+                break;
+            case event::thread_engaged:
+                snprintf(buffer, sizeof(buffer), "thread engaged at count %u", u16(0));
+                break;
+            case event::telemetry:
+                if (!telemetry(r)) {
+                    return "bad telemetry record";
+                }
+                snprintf(buffer, sizeof(buffer), "telemetry %s", csv(r).c_str());
+                break;
+            default:
+                snprintf(buffer, sizeof(buffer), "unknown event %u, %u bytes", frame[1], size());
+                break;
+            }
+            return buffer;
+        }
+
+        static constexpr const char* Csv_header = "sequence,count,error,delay,period,forward,reverse,ramping";
+
+        static std::string csv(const devices::telemetry_record_t& r) {
+            char buffer[80];
+            snprintf(buffer, sizeof(buffer), "%u,%u,%d,%u,%u,%d,%d,%d", r.sequence, r.count, static_cast<int>(r.error),
+                r.delay, r.period, r.flags & 0x1 ? 1 : 0, r.flags & 0x2 ? 1 : 0, r.flags & 0x4 ? 1 : 0);
+            return buffer;
+        }
+    };
+}